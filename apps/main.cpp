@@ -1,5 +1,6 @@
 // main.cpp
 
+#include <iostream>
 #include <memory>
 
 #include "BlobCrystallinOligomer/param.h"
@@ -8,12 +9,46 @@
 #include "BlobCrystallinOligomer/random_gens.h"
 #include "BlobCrystallinOligomer/simulation.h"
 
+#ifdef HAVE_MPI
+#include <mpi.h>
+
+#include "BlobCrystallinOligomer/mpi_simulation.h"
+#endif
+
 int main(int argc, char* argv[]) {
 
     using std::unique_ptr;
     using std::make_unique;
 
     param::InputParams params {argc, argv};
+    if (not params.m_ensemble_filenames.empty()) {
+        simulation::EnsembleMCSimulation sim {
+                params.m_ensemble_filenames,
+                params.m_reps,
+                params.m_num_threads};
+        sim.run();
+        return 0;
+    }
+    else if (params.m_sim_type == "ptmc") {
+        simulation::PTMCSimulation sim {params};
+        sim.run();
+        return 0;
+    }
+#ifdef HAVE_MPI
+    else if (params.m_sim_type == "mpi_ptmc") {
+        MPI_Init(&argc, &argv);
+        {
+            simulation::MPIPTMCSimulation sim {params};
+            sim.run();
+        }
+        MPI_Finalize();
+        return 0;
+    }
+#endif
+    else if (params.m_sim_type != "nvt") {
+        std::cout << "No such simulation type " << params.m_sim_type << "\n";
+        return 1;
+    }
     auto random_num {make_unique<random_gens::RandomGens>()};
     auto conf {make_unique<config::Config>(params, *random_num)};
     auto ene {make_unique<energy::Energy>(*conf, params)};
@@ -1,5 +1,15 @@
+from ifile_c cimport BinaryTrajectoryInputFile as BinaryTrajectoryInputFile_c
+from ifile_c cimport TrajectoryFrame as TrajectoryFrame_c
+
 cdef class VTFInputFile:
     cdef list configs
     cdef object header
 
     cpdef list get_config_positions(self, int step)
+
+cdef class BinaryTrajectoryInputFile:
+    cdef BinaryTrajectoryInputFile_c* trajfile_c
+    cdef TrajectoryFrame_c frame_c
+    cdef int frame_i
+
+    cdef void read_frame(self, int frame_i) except *
@@ -1,3 +1,7 @@
+from libcpp.string cimport string
+
+import numpy as np
+
 cdef class VTFInputFile:
     def __init__(self, filename):
         with open(filename) as inp:
@@ -34,3 +38,78 @@ cdef class VTFInputFile:
 
     cpdef list get_config_positions(self, int step):
         return self.configs[step]
+
+
+cdef class BinaryTrajectoryInputFile:
+    """Random access to the frames of a binary trajectory file
+
+    Frames are given by index, not step. The last frame read is kept, so
+    getting several properties of one frame only reads it once.
+    """
+    def __cinit__(self, filename):
+        cdef string filename_c = filename.encode('UTF-8')
+        self.trajfile_c = new BinaryTrajectoryInputFile_c(filename_c)
+        self.frame_i = -1
+
+    def __dealloc__(self):
+        del self.trajfile_c
+
+    @property
+    def num_configs(self):
+        return self.trajfile_c.get_num_frames()
+
+    @property
+    def num_monomers(self):
+        return self.trajfile_c.get_num_monomers()
+
+    @property
+    def num_particles(self):
+        return self.trajfile_c.get_num_particles()
+
+    @property
+    def box_len(self):
+        return self.trajfile_c.get_box_len()
+
+    @property
+    def radius(self):
+        return self.trajfile_c.get_radius()
+
+    def get_particle_types(self):
+        return np.array(self.trajfile_c.get_particle_types())
+
+    def get_particle_monomers(self):
+        return np.array(self.trajfile_c.get_particle_monomers())
+
+    def get_step(self, int frame_i):
+        return self.trajfile_c.get_step(frame_i)
+
+    def get_config_positions(self, int frame_i):
+        """Positions as an (particles, 3) array"""
+        self.read_frame(frame_i)
+        cdef int n = self.frame_c.positions.size()
+        positions = np.asarray(<double[:n]> self.frame_c.positions.data())
+
+        return positions.reshape(-1, 3).copy()
+
+    def get_config_orientations(self, int frame_i):
+        """Patch vectors as an (particles, 3, 3) array
+
+        The vectors of each particle are patch_norm, patch_orient and
+        patch_orient2.
+        """
+        self.read_frame(frame_i)
+        cdef int n = self.frame_c.orientations.size()
+        orientations = np.asarray(
+                <double[:n]> self.frame_c.orientations.data())
+
+        return orientations.reshape(-1, 3, 3).copy()
+
+    def get_config_conformers(self, int frame_i):
+        self.read_frame(frame_i)
+
+        return np.array(self.frame_c.conformers)
+
+    cdef void read_frame(self, int frame_i) except *:
+        if frame_i != self.frame_i:
+            self.trajfile_c.read_frame(frame_i, self.frame_c)
+            self.frame_i = frame_i
@@ -1,3 +1,4 @@
+from libc.stdint cimport int32_t
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 
@@ -12,3 +13,21 @@ cdef extern from "BlobCrystallinOligomer/ifile.h" namespace "ifile":
         vector[MonomerData] get_monomers();
         distT get_box_len();
         distT get_radius();
+
+    cdef cppclass TrajectoryFrame:
+        stepT step
+        vector[int32_t] conformers
+        vector[double] positions
+        vector[double] orientations
+
+    cdef cppclass BinaryTrajectoryInputFile:
+        BinaryTrajectoryInputFile(string filename) except +
+        int get_num_frames()
+        int get_num_monomers()
+        int get_num_particles()
+        distT get_box_len()
+        distT get_radius()
+        vector[int32_t] get_particle_types()
+        vector[int32_t] get_particle_monomers()
+        stepT get_step(int frame_i) except +
+        void read_frame(int frame_i, TrajectoryFrame& frame) except +
@@ -3,6 +3,7 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -22,11 +23,14 @@ using ifile::ParticleData;
 using monomer::Monomer;
 using param::InputParams;
 using particle::Particle;
+using particle::ParticleStore;
 using random_gens::RandomGens;
 using shared_types::CoorSet;
 using shared_types::distT;
 using shared_types::vecT;
 using space::CuboidPBC;
+using space::VerletList;
+using std::array;
 using std::reference_wrapper;
 using std::unique_ptr;
 using std::vector;
@@ -37,6 +41,10 @@ typedef vector<reference_wrapper<Monomer>> monomerArrayT;
  *
  * Holds all monomer objects and provides an interface for configuration
  * properties. Responsible for constructing monomers given monomer data.
+ * Particle coordinates are held together in a particle store.
+ * Monomer centers are indexed in a cell list with cells wide enough that
+ * only monomers in adjacent cells can be within the maximum cutoff, and
+ * optionally in Verlet lists with a skin.
  */
 class Config {
   public:
@@ -45,15 +53,56 @@ class Config {
            RandomGens& random_num,
            distT box_len,
            distT radius);
+    Config(vector<MonomerData> monomers,
+           RandomGens& random_num,
+           distT box_len,
+           distT radius,
+           distT max_cutoff,
+           distT verlet_skin);
 
     Monomer& get_monomer(int monomer_index);
 
     /**  Draw monomer with uniform probability */
     Monomer& get_random_monomer();
 
+    /** Indices of monomers in spatial order
+     *
+     * Monomers are ordered by the cell containing their current center, with
+     * cells along a Z-order (Morton) curve, so that consecutive monomers are
+     * mostly neighbours.
+     */
+    vector<int> calc_spatial_order();
+
     /** Get all monomers in system */
     monomerArrayT get_monomers();
 
+    /** Get contiguous coordinates of all particles */
+    ParticleStore& get_particle_store();
+
+    /** Get monomers that may be within the maximum cutoff of given monomer
+     *
+     * The monomer's center in the given coordinate set is used, while the
+     * returned monomers are indexed by their current centers. The given
+     * monomer is not included.
+     */
+    monomerArrayT get_monomer_neighbours(Monomer& monomer, CoorSet coorset);
+
+    /** Rebuild Verlet lists now if needed rather than on the next query */
+    void update_neighbour_lists();
+
+    /** Query only the cells for neighbours until resumed
+     *
+     * Monomers far enough apart that their cells are not adjacent may then
+     * be moved and queried from different threads.
+     */
+    void suspend_neighbour_lists();
+    void resume_neighbour_lists();
+
+    int get_cells_per_side();
+
+    /** Get indices along each axis of the cell containing the position */
+    array<int, 3> calc_cell_coors(vecT pos);
+
     int get_num_particles();
 
     int get_num_monomers();
@@ -67,6 +116,9 @@ class Config {
      */
     distT get_radius();
 
+    /** Distance between monomer centers beyond which they cannot interact */
+    distT get_interaction_len();
+
     /** Calculate vector from particle 1 to particle 2 */
     vecT calc_interparticle_vector(
             Particle& particle1,
@@ -81,6 +133,9 @@ class Config {
             Particle& particle2,
             CoorSet& coorset2);
 
+    /** Calculate distance between two positions */
+    distT calc_dist(vecT& pos1, vecT& pos2);
+
     /** Calculate distance between two monomers (centers) */
     distT calc_dist(
             Monomer& monomer1,
@@ -99,15 +154,21 @@ class Config {
     void update_config_positions(vector<vector<double>> positions);
 
   private:
+    ParticleStore m_particle_store;
     vector<unique_ptr<Monomer>> m_monomers;
     monomerArrayT m_monomer_refs;
     unique_ptr<CuboidPBC> m_space_store;
     CuboidPBC& m_space;
+    VerletList m_cells;
     RandomGens& m_random_num;
     distT m_box_len;
     distT m_radius;
+    distT m_max_cutoff;
+    distT m_verlet_skin;
+    distT m_interaction_len;
 
     void create_monomers(vector<MonomerData>);
+    void fill_cells();
 };
 } // namespace config
 
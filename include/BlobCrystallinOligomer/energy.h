@@ -9,12 +9,12 @@
 #include <vector>
 
 #include "BlobCrystallinOligomer/config.h"
-#include "BlobCrystallinOligomer/hash.h"
 #include "BlobCrystallinOligomer/ifile.h"
 #include "BlobCrystallinOligomer/monomer.h"
 #include "BlobCrystallinOligomer/param.h"
 #include "BlobCrystallinOligomer/particle.h"
-#include "BlobCrystallinOligomer/potential.h"
+#include "BlobCrystallinOligomer/potential_batch.h"
+#include "BlobCrystallinOligomer/potential_kernel.h"
 #include "BlobCrystallinOligomer/shared_types.h"
 
 namespace energy {
@@ -26,28 +26,109 @@ using ifile::PotentialData;
 using monomer::Monomer;
 using param::InputParams;
 using particle::Particle;
-using potential::PairPotential;
+using potential::PairBatch;
+using potential::PotentialKernel;
 using shared_types::CoorSet;
 using shared_types::distT;
 using shared_types::eneT;
 using std::pair;
 using std::reference_wrapper;
-using std::unique_ptr;
+using std::shared_ptr;
 using std::unordered_map;
 using std::vector;
 
+/** Potential between a pair of particle types with its squared cutoff */
+struct PairPotentialEntry {
+    const PotentialKernel* kernel {nullptr};
+    distT rcut2 {0};
+    int batch_i {-1}; // Batch for the kernel, or -1 if evaluated singly
+};
+
+/** Batches of particle pairs for each kernel and which are not empty */
+struct PairBatchSet {
+    vector<PairBatch> batches;
+    vector<int> filled;
+};
+
+/** Pair potentials of the system
+ *
+ * Contains all potentials present in system and a table from pairs of
+ * particle types and conformer relation (same or different) to their
+ * interaction potential, the first given for the pair in the energy file.
+ * Responsible for instantiating the potentials. Not modified after
+ * construction, so may be shared by the energies of several configurations
+ * of the same system.
+ */
+class PotentialTable {
+  public:
+    PotentialTable(Config& conf, InputParams& params);
+
+    /** Get potential between particle types with given conformers */
+    const PairPotentialEntry& get_pair_potential(
+            int type1,
+            int conformer1,
+            int type2,
+            int conformer2) const;
+
+    const PotentialKernel& get_kernel(int kernel_i) const;
+    int get_num_kernels() const;
+    int get_num_types() const;
+
+    /** Largest cutoff of any potential */
+    distT get_max_rcut() const;
+
+  private:
+    vector<PotentialKernel> m_kernels;
+
+    // Indexed by conformer relation (0 same, 1 different), then both types
+    vector<PairPotentialEntry> m_pair_pots;
+    int m_num_types {0};
+    bool m_fast_math {false}; // Approximate acos and exp in kernels
+
+    void create_potentials(
+            Config& conf,
+            vector<PotentialData> potentials,
+            vector<InteractionData> same_conformers_interactions,
+            vector<InteractionData> different_conformers_interactions);
+    void add_pair_potentials(
+            vector<InteractionData> interactions,
+            int relation);
+};
+
 /** System energy
  *
- * Contains all potentials present in system and maps from pairs of
- * particles to their interaction potential type. Responsible for
- * instantiating the potentials.
+ * Evaluates energies with the pair potentials of a potential table, which is
+ * either created for this configuration or shared. Particle pairs of two
+ * monomers with kernels that have batched versions are gathered and
+ * evaluated together. Full energy calculations run over neighbouring monomer
+ * pairs on multiple threads, each with its own batches. Also keeps the
+ * nonzero pair energies between monomers in their current configurations,
+ * which must be kept up to date by making trial configurations current
+ * through this class.
  */
 class Energy {
   public:
     Energy(Config& conf, InputParams& params);
+
+    /** Use an existing potential table rather than reading potentials */
+    Energy(
+            Config& conf,
+            InputParams& params,
+            shared_ptr<const PotentialTable> table);
     Energy(Config& conf, vector<PotentialData>, vector<InteractionData>);
 
-    /** Calculate total system energy */
+    shared_ptr<const PotentialTable> get_potential_table();
+
+    /** Set the nesting level of parallel regions moves are made from
+     *
+     * Threads only have their own batches and commit counts within regions
+     * entered from this level, so that an energy can be used by any thread
+     * of an outer team, such as one running replicas. Defaults to the level
+     * of construction.
+     */
+    void set_serial_level();
+
+    /** Calculate total system energy from all neighbouring monomer pairs */
     eneT calc_total_energy();
 
     /** Calculate pair energy between two monomers */
@@ -64,12 +145,51 @@ class Energy {
             Monomer& monomer2,
             CoorSet coorset2);
 
+    /** Check if monomers close enough for any particles to interact */
+    bool monomers_in_range(
+            Monomer& monomer1,
+            CoorSet coorset1,
+            Monomer& monomer2,
+            CoorSet coorset2);
+
     /** Create list of monomers interacting with given monomer */
     monomerArrayT get_interacting_monomers(Monomer& monomer1, CoorSet coorset1);
 
-    /** Calculate energy difference between current and trial */
+    /** Calculate energy difference between current and trial
+     *
+     * Only trial pair energies are calculated, current pair energies are
+     * taken from the cache.
+     */
     eneT calc_monomer_diff(Monomer& monomer);
 
+    /** Get cached pair energy between two monomers in current configs */
+    eneT get_pair_energy(Monomer& monomer1, Monomer& monomer2);
+
+    /** Make trial configuration of monomer current and update cache
+     *
+     * The trial pair energies found in the last call to calc_monomer_diff for
+     * this monomer are reused if no monomers have been made current since by
+     * the calling thread. Threads may only move monomers concurrently if
+     * they are far enough apart to share no neighbours. Returns the change in
+     * system energy.
+     */
+    eneT trial_to_current(Monomer& monomer);
+
+    /** Allow calling thread to reuse trial pair energies of monomer
+     *
+     * The caller must ensure that no monomer made current since they were
+     * found is within interaction range of the monomer.
+     */
+    void keep_trial_pair_energies(Monomer& monomer);
+
+    /** Make trial configuration of monomers current and update cache
+     *
+     * Pair energies of the monomers, including those between them, are
+     * recalculated, as clusters spanning the box are not rigid after
+     * unwrapping. Returns the change in system energy.
+     */
+    eneT trial_to_current(monomerArrayT& monomers);
+
     /** Check if particles within range to have non-zero pair potential */
     bool particles_interacting(
             Particle& particle1,
@@ -90,22 +210,81 @@ class Energy {
 
   private:
     Config& m_config;
-    vector<unique_ptr<PairPotential>> m_potentials;
-    unordered_map<pair<int, int>, reference_wrapper<PairPotential>>
-            m_same_pair_to_pot;
-    unordered_map<pair<int, int>, reference_wrapper<PairPotential>>
-            m_different_pair_to_pot;
+    shared_ptr<const PotentialTable> m_table;
     distT m_max_cutoff;
+    int m_num_threads {1};
+    int m_serial_level {0};
 
-    void create_potentials(
-            vector<PotentialData> potentials,
-            vector<InteractionData> same_conformers_interactions,
-            vector<InteractionData> different_conformers_interactions);
-    bool monomers_in_range(
+    // Pairs gathered for batched kernels, one set for each thread
+    vector<PairBatchSet> m_batch_sets;
+
+    // Cache of nonzero pair energies between monomers in current configs
+    vector<unordered_map<int, eneT>> m_pair_enes;
+
+    // Nonzero trial pair energies found in last calc_monomer_diff of each
+    // monomer and commit count of the thread at that time (-1 if not usable)
+    vector<vector<pair<int, eneT>>> m_trial_pair_enes;
+    vector<long> m_trial_pair_enes_commit;
+
+    // Commit counts of each thread, which start at the thread number and
+    // step by the number of threads so that no two threads share a count
+    vector<long> m_commits;
+
+    vector<bool> m_recalculated; // Monomers with pairs already recalculated
+
+    /** Check table covers configuration and set up energy cache */
+    void initialize();
+    const PairPotentialEntry& get_pair_potential(
+            Particle& particle1,
+            int conformer1,
+            Particle& particle2,
+            int conformer2);
+    eneT calc_monomer_pair_energy(
             Monomer& monomer1,
             CoorSet coorset1,
             Monomer& monomer2,
-            CoorSet coorset2);
+            CoorSet coorset2,
+            PairBatchSet& batch_set);
+
+    /** Sum and empty all filled batches */
+    eneT calc_batch_energies(PairBatchSet& batch_set);
+    void clear_batches(PairBatchSet& batch_set);
+
+    /** Index of the calling thread within a region entered from the serial
+     * level, or 0 at or outside it */
+    int get_thread_index();
+
+    /** Batches for the calling thread within a parallel region */
+    PairBatchSet& get_thread_batch_set();
+
+    /** Commit count of the calling thread */
+    long& get_thread_commits();
+
+    /** Calculate current energies with neighbours of higher index
+     *
+     * Appends nonzero energies to pair_enes and returns their sum.
+     */
+    eneT calc_upper_pair_energies(
+            Monomer& monomer,
+            PairBatchSet& batch_set,
+            vector<pair<int, eneT>>& pair_enes);
+
+    /** Sum of current energies with neighbours of higher index */
+    eneT calc_upper_pair_energies(Monomer& monomer, PairBatchSet& batch_set);
+    void fill_pair_energies();
+    void set_pair_energy(int monomer_i1, int monomer_i2, eneT ene);
+
+    /** Remove all cached energies of monomer
+     *
+     * Returns the sum of the removed energies.
+     */
+    eneT clear_pair_energies(int monomer_i);
+
+    /** Calculate and cache energies of monomer with those not recalculated
+     *
+     * Returns the sum of the new energies.
+     */
+    eneT calc_pair_energies(Monomer& monomer);
 };
 } // namespace energy
 
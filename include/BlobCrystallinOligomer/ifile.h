@@ -3,6 +3,7 @@
 #ifndef IFILE_H
 #define IFILE_H
 
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <unordered_map>
@@ -100,6 +101,83 @@ class InputEnergyFile {
 
     void parse_json();
 };
+
+/** Binary trajectory format
+ *
+ * Files start with a fixed header, followed by the particle types and
+ * monomer indices (int32 each, in output order), and then fixed size
+ * frames. Each frame holds the step (uint64), the monomer conformers (int32,
+ * padded to 8 bytes), the particle positions (3 doubles each) and the
+ * particle patch vectors (patch_norm, patch_orient and patch_orient2, 9
+ * doubles each). When the file is closed an index of (step, offset) pairs
+ * (uint64 each) is appended and the header is updated to point to it. All
+ * values are in host byte order.
+ */
+constexpr char binary_trajectory_magic[8] {
+        'B', 'C', 'O', 'T', 'R', 'A', 'J', '\0'};
+constexpr std::uint32_t binary_trajectory_version {1};
+
+struct BinaryTrajectoryHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_monomers;
+    std::uint32_t num_particles;
+    std::uint32_t padding;
+    double box_len;
+    double radius;
+    std::uint64_t frame_bytes;
+    std::uint64_t num_frames; // Zero until the index is written
+    std::uint64_t index_offset; // Zero until the index is written
+};
+
+static_assert(sizeof(BinaryTrajectoryHeader) == 64);
+
+/** Size in bytes of one frame of the binary trajectory format */
+std::uint64_t calc_binary_frame_bytes(int num_monomers, int num_particles);
+
+/** One frame of a binary trajectory
+ *
+ * Coordinates are stored flat in the order they are in the file.
+ */
+struct TrajectoryFrame {
+    stepT step;
+    vector<std::int32_t> conformers;
+    vector<double> positions;
+    vector<double> orientations;
+};
+
+/** Binary trajectory format for random access to frames
+ *
+ * Files that were not closed have no index. Their complete frames are found
+ * from the file size.
+ */
+class BinaryTrajectoryInputFile {
+  public:
+    BinaryTrajectoryInputFile(string filename);
+    int get_num_frames();
+    int get_num_monomers();
+    int get_num_particles();
+    distT get_box_len();
+    distT get_radius();
+    vector<std::int32_t> get_particle_types();
+    vector<std::int32_t> get_particle_monomers();
+    stepT get_step(int frame_i);
+
+    /** Read a frame into an existing frame to reuse its storage */
+    void read_frame(int frame_i, TrajectoryFrame& frame);
+
+  private:
+    std::ifstream m_file;
+    BinaryTrajectoryHeader m_header;
+    vector<std::int32_t> m_particle_types;
+    vector<std::int32_t> m_particle_monomers;
+    vector<stepT> m_steps;
+    vector<std::uint64_t> m_offsets;
+
+    void read_index();
+    void recover_index();
+    void read(void* data, std::uint64_t bytes);
+};
 } // namespace ifile
 
 #endif // IFILE_H
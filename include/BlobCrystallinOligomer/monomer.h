@@ -16,10 +16,12 @@ namespace monomer {
 using ifile::MonomerData;
 using ifile::ParticleData;
 using particle::Particle;
+using particle::ParticleStore;
 using shared_types::CoorSet;
 using shared_types::distT;
 using shared_types::rotMatT;
 using shared_types::vecT;
+using space::CellList;
 using space::CuboidPBC;
 using std::reference_wrapper;
 using std::unique_ptr;
@@ -33,11 +35,15 @@ typedef vector<reference_wrapper<Particle>> particleArrayT;
 /** alphB cyrstallin coarse grained monomer
  *
  * Contains the particles that make it up and an interface for manipulating
- * the configuration.
+ * the configuration. Particle coordinates are added to the given store
+ * contiguously.
  */
 class Monomer {
   public:
-    Monomer(MonomerData m_data, CuboidPBC& pbc_space);
+    Monomer(MonomerData m_data,
+            CuboidPBC& pbc_space,
+            CellList& cells,
+            ParticleStore& store);
 
     /** Unique index */
     int get_index();
@@ -71,7 +77,10 @@ class Monomer {
     /** Flip conformation */
     void flip_conformation();
 
-    /** Make trial configuration current configuration */
+    /** Make trial configuration current configuration
+     *
+     * Also moves the monomer to the cell containing its new center.
+     */
     void trial_to_current();
 
     /** Reset trial to current */
@@ -82,13 +91,17 @@ class Monomer {
     int m_trial_conformer;
     int m_conformer;
     CuboidPBC& m_space;
+    CellList& m_cells;
 
     vector<unique_ptr<Particle>> m_particles;
     particleArrayT m_particle_refs;
     int m_num_particles;
     distT m_r;
 
-    void create_particles(vector<ParticleData> p_datas, CuboidPBC& pbc_space);
+    void create_particles(
+            vector<ParticleData> p_datas,
+            CuboidPBC& pbc_space,
+            ParticleStore& store);
     void calc_monomer_radius();
 };
 } // namespace monomer
@@ -3,10 +3,12 @@
 #ifndef MOVETYPE_H
 #define MOVETYPE_H
 
+#include <array>
 #include <cmath>
 #include <memory>
-#include <set>
+#include <ostream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -26,15 +28,18 @@ using config::monomerArrayT;
 using energy::Energy;
 using param::InputParams;
 using random_gens::RandomGens;
+using shared_types::CoorSet;
 using shared_types::distT;
 using shared_types::eneT;
 using shared_types::rotMatT;
 using shared_types::vecT;
+using std::array;
+using std::ostream;
 using std::pair;
-using std::set;
 using std::sqrt;
 using std::string;
 using std::unique_ptr;
+using std::unordered_map;
 using std::vector;
 
 /** Return a unit vector with uniform distrition across sphere surface */
@@ -55,6 +60,12 @@ class Movemap {
     virtual void generate_movemap(Monomer& monomer) = 0;
     virtual void apply_movemap(Monomer& monomer) = 0;
 
+    /** Multiply maximum displacements by factor */
+    virtual void scale_amplitudes(double) {}
+
+    /** Write maximum displacements, one per line */
+    virtual void write_amplitudes(ostream&) {}
+
   protected:
     RandomGens& m_random_num;
 };
@@ -67,6 +78,8 @@ class TranslationMovemap: public Movemap {
 
     void generate_movemap(Monomer&);
     void apply_movemap(Monomer& monomer);
+    void scale_amplitudes(double factor);
+    void write_amplitudes(ostream& out);
 
   private:
     distT m_max_disp_tc;
@@ -90,6 +103,10 @@ class RotationMovemap: public Movemap {
     void generate_movemap(Monomer& monomer);
     void apply_movemap(Monomer& monomer);
 
+    /** Scale both displacements, with the angle at most a full turn */
+    void scale_amplitudes(double factor);
+    void write_amplitudes(ostream& out);
+
   private:
     distT m_max_disp_rc;
     distT m_max_disp_a;
@@ -118,6 +135,13 @@ class NTDFlipMovemap: public Movemap {
     vecT m_point_in_plane;
 };
 
+/** Create movemap of given type (translation, rotation or ntdflip) */
+unique_ptr<Movemap> create_movemap(
+        string movemap_type,
+        Config& conf,
+        InputParams& params,
+        RandomGens& random_num);
+
 /** General movetype interface */
 class MCMovetype {
   public:
@@ -134,6 +158,27 @@ class MCMovetype {
 
     string get_label();
 
+    /** Energy change of last move (0 if rejected) */
+    eneT get_de();
+
+    /** Sum of squared displacements of monomer centers in last move */
+    distT get_disp2();
+
+    void set_beta(eneT beta);
+
+    /** Multiply maximum displacements of movemaps by factor */
+    virtual void scale_amplitudes(double factor);
+    void write_amplitudes(ostream& out);
+
+    /** Select monomers in sweeps in spatial order rather than at random
+     *
+     * The order is found once, from the configuration when sweeps are set,
+     * so that which monomer is moved never depends on the state. Each move
+     * then leaves the distribution invariant, so sweeps satisfy balance but
+     * not detailed balance. Locality is lost as monomers diffuse.
+     */
+    void set_sweep(bool sweep);
+
   protected:
     Config& m_config;
     Energy& m_energy;
@@ -141,6 +186,17 @@ class MCMovetype {
     eneT m_beta;
     string m_label;
     unique_ptr<Movemap> m_movemap;
+    eneT m_de {0};
+    distT m_disp2 {0};
+    bool m_sweep {false};
+    vector<int> m_sweep_order;
+    size_t m_sweep_pos {0};
+
+    /** Squared displacement of monomer center in its trial config */
+    distT calc_disp2(Monomer& monomer);
+
+    /** Next monomer of the sweep, or a random monomer if not sweeping */
+    Monomer& select_monomer();
 };
 
 /** Metropolis move */
@@ -159,9 +215,125 @@ class MetMCMovetype: public MCMovetype {
 
   protected:
     bool accept_move(eneT de);
+    bool accept_move(eneT de, RandomGens& random_num);
 };
 
-/** Virtual move */
+/** Metropolis moves of several monomers on multiple threads
+ *
+ * Holds a random number generator and movemap for each thread.
+ */
+class ParallelMetMCMovetype: public MetMCMovetype {
+
+  public:
+    ParallelMetMCMovetype(
+            Config& conf,
+            Energy& ene,
+            RandomGens& random_num,
+            InputParams params,
+            string label,
+            string movemap_type);
+
+    void scale_amplitudes(double factor);
+
+  protected:
+    int m_num_threads;
+    vector<unique_ptr<RandomGens>> m_thread_random_nums;
+    vector<unique_ptr<Movemap>> m_thread_movemaps;
+
+    /** Number of the calling thread within a parallel region */
+    int get_thread_num();
+};
+
+/** Parallel Metropolis sweep over checkerboard domains
+ *
+ * The box is divided into domains of whole cells at least two cells wide,
+ * and each domain is given one of eight colours so that domains of the same
+ * colour are never adjacent. Each move is a sweep over the colours in turn,
+ * with the domains of a colour processed concurrently, each by as many
+ * single monomer moves as it has monomers. Moves that take a monomer's
+ * center out of its domain are rejected. The domain offsets and order of
+ * colours are drawn for each sweep, so that every single monomer move is
+ * possible while each colour keeps detailed balance. With fewer than eight
+ * cells per side there is only one domain of each colour. The move is
+ * accepted if any single monomer move is.
+ */
+class CheckerboardMetMCMovetype: public ParallelMetMCMovetype {
+
+  public:
+    CheckerboardMetMCMovetype(
+            Config& conf,
+            Energy& ene,
+            RandomGens& random_num,
+            InputParams params,
+            string label,
+            string movemap_type);
+
+    bool move();
+
+  protected:
+    int m_cells_per_side;
+    int m_domains_per_side;
+    vector<int> m_cell_domains; // Domain along an axis of each shifted cell
+    vector<vector<int>> m_colour_domains;
+    vector<vector<int>> m_domain_monomers; // As of the start of the sweep
+    array<int, 3> m_offset; // Cell shift of the domains for the sweep
+
+    int calc_domain(vecT pos);
+
+    /** Move monomers of domain and return the energy change */
+    eneT sweep_domain(int domain_i, int& accepts, distT& disp2);
+};
+
+/** Metropolis moves evaluated speculatively in parallel
+ *
+ * Each move is a batch of single monomer moves of distinct monomers, whose
+ * energy differences are calculated concurrently from the same
+ * configuration. The moves are then accepted or rejected in order. A move
+ * whose monomer is within interaction range of a monomer made current
+ * earlier in the batch, at either of their positions, is first evaluated
+ * again. The move is accepted if any single monomer move is.
+ */
+class SpeculativeMetMCMovetype: public ParallelMetMCMovetype {
+
+  public:
+    SpeculativeMetMCMovetype(
+            Config& conf,
+            Energy& ene,
+            RandomGens& random_num,
+            InputParams params,
+            string label,
+            string movemap_type);
+
+    bool move();
+
+  protected:
+    int m_batch_size;
+    vector<int> m_monomer_order; // First batch size entries are proposed
+    vector<vecT> m_centers;
+    vector<vecT> m_trial_centers;
+    vector<eneT> m_des;
+    vector<int> m_committed; // Proposals made current so far in batch
+
+    /** Check if proposal is in range of a committed proposal */
+    bool conflicts(int proposal_i);
+};
+
+/** Virtual move
+ *
+ * The movemap is only applied to a candidate monomer once its prelink has
+ * been accepted, as its trial config is not needed before then, and only
+ * transformed monomers are reset after the move.
+ *
+ * Pair energies found during a move are kept until the end of the move. The
+ * forward link energies of the candidates of each new cluster monomer are
+ * found when it is added, concurrently with multiple threads, and are used
+ * both to filter out candidates that can never be linked and in the link
+ * tests, which are made serially.
+ *
+ * Membership of monomers in the cluster and other per-move sets is recorded
+ * in dense arrays stamped with the move (or proposal) number, so that they
+ * never need to be searched or cleared.
+ */
 class VMMCMovetype: public MCMovetype {
 
   public:
@@ -175,16 +347,56 @@ class VMMCMovetype: public MCMovetype {
 
     bool move();
 
-  private:
+  protected:
     monomerArrayT m_cluster;
     int m_frustrated_links {0};
-    vector<int> m_frustrated_mis {};
-    set<pair<int, int>> m_proposed_pairs {};
-    set<int> m_interacting_mis;
-    set<pair<int, int>> m_pair_mis;
-    unique_ptr<Movemap> m_movemap;
+    vector<int> m_transformed_mis; // Movemap applied
+    vector<pair<int, int>> m_pair_mis; // Unordered, popped by swap
+
+    // Stamps of each monomer
+    long m_move_stamp {0};
+    long m_proposal_stamp {0};
+    vector<long> m_cluster_stamps;
+    vector<long> m_transformed_stamps;
+    vector<long> m_proposed_stamps; // Proposed as partner of current monomer
+    vector<long> m_frustrated_stamps;
+    vector<int> m_frustrated_counts; // Frustrated links to each monomer
+    int m_num_threads;
+
+    // Pair energies found this move, keyed by twice the monomer indices
+    // plus one for trial configs
+    unordered_map<pair<int, int>, eneT> m_pair_enes;
+
+    // Candidate partners of the monomer being added to the cluster
+    vector<int> m_candidate_mis;
+    vector<eneT> m_candidate_enes;
 
     void add_interacting_pairs(Monomer& monomer1);
+
+    /** Add monomer to cluster, unfrustrating any links to it */
+    void add_to_cluster(Monomer& monomer);
+
+    /** Record a rejected link from the cluster to a monomer */
+    void frustrate_link(int monomer_i);
+    bool in_cluster(int monomer_i);
+
+    /** Apply the movemap if it has not been applied already this move */
+    void transform(Monomer& monomer);
+
+    /** Pair energy, calculated at most once per move
+     *
+     * Monomers in their trial configs must have been transformed.
+     */
+    eneT get_memo_pair_energy(
+            Monomer& monomer1,
+            CoorSet coorset1,
+            Monomer& monomer2,
+            CoorSet coorset2);
+    pair<int, int> memo_key(
+            Monomer& monomer1,
+            CoorSet coorset1,
+            Monomer& monomer2,
+            CoorSet coorset2);
     pair<int, int> pop_random_pair();
     double calc_prelink_prob(eneT ene1, eneT ene2);
     bool accept_prelink(double prelink_p);
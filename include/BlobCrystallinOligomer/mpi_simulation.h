@@ -0,0 +1,86 @@
+// mpi_simulation.h
+
+#ifndef MPI_SIMULATION_H
+#define MPI_SIMULATION_H
+
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "BlobCrystallinOligomer/config.h"
+#include "BlobCrystallinOligomer/energy.h"
+#include "BlobCrystallinOligomer/ofile.h"
+#include "BlobCrystallinOligomer/param.h"
+#include "BlobCrystallinOligomer/random_gens.h"
+#include "BlobCrystallinOligomer/shared_types.h"
+#include "BlobCrystallinOligomer/simulation.h"
+
+namespace simulation {
+
+using ofile::ConfigFrame;
+
+/** Parallel tempering with one replica per MPI process
+ *
+ * Each rank runs a canonical simulation of one replica. Only temperatures
+ * are exchanged between ranks, with swaps decided on rank 0. Configuration
+ * output follows the temperature: each frame is sent to the rank with the
+ * index of the replica's current temperature, which owns the output files
+ * for that temperature (suffixed with the temperature index). Energy checks
+ * and move summaries of each replica are written to
+ * <filebase>-replica-<rank>.log, and exchanges are logged by rank 0.
+ *
+ * MPI must be initialized before construction, and the number of ranks must
+ * equal the number of temperatures.
+ */
+class MPIPTMCSimulation {
+  public:
+    MPIPTMCSimulation(InputParams params);
+    void run();
+
+  private:
+    int m_rank;
+    vector<eneT> m_temps; // Increasing
+
+    std::ofstream m_log;
+    RandomGens m_random_num;
+    unique_ptr<Config> m_config;
+    unique_ptr<Energy> m_energy;
+    unique_ptr<NVTMCSimulation> m_replica;
+    int m_temp_i; // Temperature of this rank's replica
+
+    // Output for the temperature with this rank's index
+    unique_ptr<TrajectoryWriter> m_traj_writer;
+    ConfigFrame m_frame;
+    ConfigFrame m_temp_frame;
+
+    // Only used on rank 0
+    RandomGens m_exchange_random_num;
+    vector<eneT> m_replica_enes;
+    vector<stepT> m_swap_attempts;
+    vector<stepT> m_swap_accepts;
+
+    vector<int> m_temp_replicas; // Replica (rank) at each temperature
+    long m_exchanges {0};
+
+    stepT m_steps;
+    timeT m_duration;
+    stepT m_exchange_freq;
+    stepT m_energy_check_freq;
+    stepT m_logging_freq;
+    stepT m_config_output_freq;
+
+    /** Attempt swaps between neighbouring temperatures
+     *
+     * Alternates between the even and odd pairs of temperatures.
+     */
+    void attempt_exchanges();
+
+    /** Send each replica's configuration to the writer of its temperature */
+    void write_frames(stepT step);
+
+    void log_exchange(stepT step);
+    void log_summary();
+};
+} // namespace simulation
+
+#endif // MPI_SIMULATION_H
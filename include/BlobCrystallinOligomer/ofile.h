@@ -3,26 +3,53 @@
 #ifndef OFILE_H
 #define OFILE_H
 
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "BlobCrystallinOligomer/config.h"
+#include "BlobCrystallinOligomer/ifile.h"
+#include "BlobCrystallinOligomer/particle.h"
 #include "BlobCrystallinOligomer/shared_types.h"
 #include "Json/json.hpp"
 
 namespace ofile {
 
 using config::Config;
+using ifile::BinaryTrajectoryHeader;
+using particle::Orientation;
 using shared_types::distT;
 using shared_types::stepT;
+using shared_types::vecT;
 using std::string;
+using std::unique_ptr;
 using std::unordered_map;
+using std::vector;
 
 typedef nlohmann::json json;
 
+/** Copy of the current coordinates of all particles at a step
+ *
+ * Particles are stored in output order (by monomer, then by particle within
+ * the monomer).
+ */
+struct ConfigFrame {
+    stepT step;
+    vector<int> conformers;
+    vector<vecT> positions;
+    vector<Orientation> orientations;
+
+    /** Copy current coordinates from configuration */
+    void snapshot(Config& conf, stepT frame_step);
+};
+
 /** Base class for output files */
 class OutputFile {
   public:
@@ -47,6 +74,12 @@ class VSFOutputFile: virtual public OutputFile {
      * For now this is just the box size and the particle radii
      */
     void write_structure(Config& conf);
+
+    /** Write the structure from the last call with a configuration */
+    void write_structure();
+
+  protected:
+    string m_structure;
 };
 
 /** VCF file format for position frame output */
@@ -57,7 +90,12 @@ class VCFOutputFile: virtual public OutputFile {
 
     /** Write configuration at current step */
     void write_step(Config& config, stepT step);
+    void write_step(const ConfigFrame& frame);
     void open_write_step_close(Config& config, stepT step);
+    void open_write_step_close(const ConfigFrame& frame);
+
+  private:
+    ConfigFrame m_frame; // Snapshot of configurations written directly
 };
 
 /** VTF file format for topology and position frame output */
@@ -68,6 +106,7 @@ class VTFOutputFile:
   public:
     VTFOutputFile(string filename, Config& conf);
     void open_write_close(Config& config, stepT step);
+    void open_write_close(const ConfigFrame& frame);
 };
 
 /** Simple output format for patch vectors
@@ -79,7 +118,93 @@ class PatchOutputFile: virtual public OutputFile {
   public:
     PatchOutputFile(string filename);
     void write_step(Config& conf);
+    void write_step(const ConfigFrame& frame);
     void open_write_step_close(Config& conf);
+    void open_write_step_close(const ConfigFrame& frame);
+
+  private:
+    ConfigFrame m_frame; // Snapshot of configurations written directly
+};
+
+/** Binary trajectory format with a frame index
+ *
+ * See ifile::BinaryTrajectoryHeader for the layout. The index is written
+ * when the file is closed.
+ */
+class BinaryTrajectoryOutputFile: virtual public OutputFile {
+  public:
+    BinaryTrajectoryOutputFile(string filename, Config& conf);
+    BinaryTrajectoryOutputFile(const BinaryTrajectoryOutputFile&) = delete;
+    BinaryTrajectoryOutputFile& operator=(
+            const BinaryTrajectoryOutputFile&) = delete;
+    ~BinaryTrajectoryOutputFile();
+
+    void write_step(Config& conf, stepT step);
+    void write_step(const ConfigFrame& frame);
+
+    /** Write the frame index and close */
+    void close();
+
+  private:
+    BinaryTrajectoryHeader m_header;
+    vector<stepT> m_steps;
+    vector<std::uint64_t> m_offsets;
+    std::uint64_t m_offset;
+    ConfigFrame m_frame;
+    vector<char> m_buffer;
+};
+
+/** Configuration output written on a background thread
+ *
+ * Owns the trajectory files, either VTF and patch or binary, and the VTF
+ * and patch pipe files, which only ever hold the latest frame. Frames are
+ * copied into one of a fixed number of buffers and written by the writer
+ * thread, so the simulation only waits when every buffer is still queued.
+ * With zero buffers frames are written directly on the calling thread.
+ */
+class TrajectoryWriter {
+  public:
+    TrajectoryWriter(
+            string filebase,
+            Config& conf,
+            int buffer_frames,
+            bool binary = false);
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    /** Write any queued frames and stop the writer thread */
+    ~TrajectoryWriter();
+
+    /** Output current configuration */
+    void write_frame(Config& conf, stepT step);
+
+    /** Output a copy of a frame */
+    void write_frame(const ConfigFrame& frame);
+
+  private:
+    unique_ptr<VTFOutputFile> m_vtf_file;
+    unique_ptr<PatchOutputFile> m_patch_file;
+    unique_ptr<BinaryTrajectoryOutputFile> m_binary_file;
+    VTFOutputFile m_pipe_vtf_file;
+    PatchOutputFile m_pipe_patch_file;
+
+    vector<ConfigFrame> m_frames;
+    std::deque<int> m_free_frames;
+    std::deque<int> m_queued_frames;
+    std::mutex m_frames_mutex;
+    std::condition_variable m_frame_freed;
+    std::condition_variable m_frame_queued;
+    bool m_finished {false};
+    std::thread m_writer;
+
+    /** Get a free frame buffer, waiting for one if necessary */
+    int acquire_frame();
+
+    /** Queue a filled frame buffer, or write it if there is no writer */
+    void queue_frame(int frame_i);
+
+    void write(const ConfigFrame& frame);
+    void run_writer();
 };
 } // namespace ofile
 
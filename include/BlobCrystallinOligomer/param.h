@@ -4,9 +4,14 @@
 #define PARAM_H
 
 #include <string>
+#include <vector>
 
 #include "BlobCrystallinOligomer/shared_types.h"
 
+namespace boost::program_options {
+class options_description;
+} // namespace boost::program_options
+
 namespace param {
 
 using shared_types::distT;
@@ -14,6 +19,7 @@ using shared_types::eneT;
 using shared_types::stepT;
 using shared_types::timeT;
 using std::string;
+using std::vector;
 
 /** Parse fractions in strings
  *
@@ -35,6 +41,13 @@ class InputParams {
   public:
     InputParams(int argc, char* argv[]);
 
+    /** Parse parameter file only, e.g. for each member of an ensemble */
+    InputParams(string param_filename);
+
+    // Ensemble (command line only)
+    vector<string> m_ensemble_filenames;
+    int m_reps;
+
     // System input
     string m_config_filename;
     string m_energy_filename;
@@ -44,22 +57,45 @@ class InputParams {
     stepT m_steps;
     timeT m_duration;
     distT m_max_cutoff; // Not very nice to put here
+    distT m_verlet_skin;
+    stepT m_energy_check_freq;
+    bool m_fast_math;
+    int m_num_threads;
+
+    // Parallel tempering
+    string m_sim_type;
+    vector<eneT> m_temps;
+    stepT m_exchange_freq;
 
     // Movetypes
     distT m_max_disp_tc;
     distT m_max_disp_rc;
     distT m_max_disp_a;
+    stepT m_tune_steps;
+    stepT m_tune_interval;
+    double m_tune_target_accept;
+    stepT m_schedule_steps;
     double m_translation_met;
     double m_rotation_met;
     double m_translation_vmmc;
     double m_rotation_vmmc;
     double m_ntd_flip;
+    double m_translation_checkerboard;
+    double m_rotation_checkerboard;
+    double m_ntd_flip_checkerboard;
+    double m_translation_speculative;
+    double m_rotation_speculative;
+    double m_ntd_flip_speculative;
+    int m_speculative_batch;
+    vector<string> m_sweep_movetypes;
 
     // Output
     string m_output_filebase;
     stepT m_logging_freq;
     stepT m_config_output_freq;
     stepT m_op_output_freq;
+    int m_output_buffer_frames;
+    bool m_binary_trajectory;
 
   private:
     string m_rotation_met_raw;
@@ -67,6 +103,18 @@ class InputParams {
     string m_rotation_vmmc_raw;
     string m_translation_vmmc_raw;
     string m_ntd_flip_raw;
+    string m_translation_checkerboard_raw;
+    string m_rotation_checkerboard_raw;
+    string m_ntd_flip_checkerboard_raw;
+    string m_translation_speculative_raw;
+    string m_rotation_speculative_raw;
+    string m_ntd_flip_speculative_raw;
+    string m_temps_raw;
+    string m_sweep_movetypes_raw;
+
+    /*  Options that may be given in a parameter file */
+    void add_file_options(
+            boost::program_options::options_description& options);
 
     /*  Process inputs that require more than default constructor */
     void post_process_inputs();
@@ -3,6 +3,9 @@
 #ifndef PARTICLE_H
 #define PARTICLE_H
 
+#include <memory>
+#include <vector>
+
 #include "BlobCrystallinOligomer/shared_types.h"
 #include "BlobCrystallinOligomer/space.h"
 
@@ -12,6 +15,8 @@ using shared_types::CoorSet;
 using shared_types::rotMatT;
 using shared_types::vecT;
 using space::CuboidPBC;
+using std::unique_ptr;
+using std::vector;
 
 /** Particle orientation
  *
@@ -23,12 +28,47 @@ struct Orientation {
     vecT patch_orient2 {0, 0, 0};
 };
 
+/** Contiguous storage of particle coordinates
+ *
+ * Current and trial positions and orientations of all particles are kept in
+ * separate arrays indexed by a global particle index, with the particles of
+ * each monomer adjacent. Each element is a whole vector or orientation
+ * rather than a single component, as particles and potentials take
+ * references to them; splitting components into their own arrays would need
+ * views in place of those references.
+ */
+class ParticleStore {
+  public:
+    ParticleStore();
+
+    /** Add particle with both coordinate sets as given and return index */
+    int add_particle(vecT pos, Orientation ore);
+
+    int get_num_particles();
+    vecT& get_pos(int particle_i, CoorSet coorset);
+    Orientation& get_ore(int particle_i, CoorSet coorset);
+
+    /** Make trial coordinates of particle current */
+    void trial_to_current(int particle_i);
+
+    /** Reset trial coordinates of particle with current */
+    void current_to_trial(int particle_i);
+
+  private:
+    vector<vecT> m_pos;
+    vector<vecT> m_trial_pos;
+    vector<Orientation> m_ore;
+    vector<Orientation> m_trial_ore;
+};
+
 /** General class for particles, the basic building blocks of structures
  *
- * Contains position vector and type (for deciding interaction potentials.
- * There is both a current position and a trial position for easily reverting
- * changes to the configurations if moves are rejected. Also provides shared
- * interface and implementation for more complex particle types with patches.
+ * Contains type (for deciding interaction potentials) and a view of its
+ * coordinates in a particle store. There is both a current position and a
+ * trial position for easily reverting changes to the configurations if moves
+ * are rejected. Also provides shared interface and implementation for more
+ * complex particle types with patches. Particles constructed without a store
+ * own a store of their own.
  */
 class Particle {
   public:
@@ -38,10 +78,20 @@ class Particle {
             vecT pos,
             Orientation ore,
             CuboidPBC& pbc_space);
+    Particle(
+            int index,
+            int type,
+            vecT pos,
+            Orientation ore,
+            CuboidPBC& pbc_space,
+            ParticleStore& store);
     virtual ~Particle() {}
 
     int get_index();
     int get_type();
+
+    /** Index of coordinates in the particle store */
+    int get_store_index();
     vecT& get_pos(CoorSet coorset);
     Orientation& get_ore(CoorSet coorset);
 
@@ -60,15 +110,12 @@ class Particle {
     /** Reset trial with current */
     void current_to_trial();
 
-  protected:
-    Orientation m_ore;
-    Orientation m_trial_ore;
-
   private:
     int m_index; // Unique sphere index
     int m_type; // Particle type
-    vecT m_pos;
-    vecT m_trial_pos;
+    unique_ptr<ParticleStore> m_own_store;
+    ParticleStore& m_store;
+    int m_store_i;
     CuboidPBC& m_space;
 };
 
@@ -81,6 +128,13 @@ class PatchyParticle: public Particle {
             vecT pos,
             Orientation ore,
             CuboidPBC& pbc_space);
+    PatchyParticle(
+            int index,
+            int type,
+            vecT pos,
+            Orientation ore,
+            CuboidPBC& pbc_space,
+            ParticleStore& store);
     virtual void rotate(vecT& rot_c, rotMatT& rot_mat);
 };
 
@@ -93,6 +147,13 @@ class OrientedPatchyParticle: public PatchyParticle {
             vecT pos,
             Orientation ore,
             CuboidPBC& pbc_space);
+    OrientedPatchyParticle(
+            int index,
+            int type,
+            vecT pos,
+            Orientation ore,
+            CuboidPBC& pbc_space,
+            ParticleStore& store);
     void rotate(vecT& rot_c, rotMatT& rot_mat);
 };
 
@@ -105,6 +166,13 @@ class DoubleOrientedPatchyParticle: public PatchyParticle {
             vecT pos,
             Orientation ore,
             CuboidPBC& pbc_space);
+    DoubleOrientedPatchyParticle(
+            int index,
+            int type,
+            vecT pos,
+            Orientation ore,
+            CuboidPBC& pbc_space,
+            ParticleStore& store);
     void rotate(vecT& rot_c, rotMatT& rot_mat);
 };
 } // namespace particle
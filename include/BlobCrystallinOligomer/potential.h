@@ -34,6 +34,9 @@ class PairPotential {
     /** Check if pair potential is non-zero */
     bool particles_interacting(distT rdist);
 
+    /** Distance at and beyond which the potential is zero */
+    distT get_rcut();
+
   private:
     distT m_rcut;
 };
@@ -0,0 +1,65 @@
+// potential_batch.h
+
+#ifndef POTENTIAL_BATCH_H
+#define POTENTIAL_BATCH_H
+
+#include <vector>
+
+#include "BlobCrystallinOligomer/particle.h"
+#include "BlobCrystallinOligomer/potential_kernel.h"
+#include "BlobCrystallinOligomer/shared_types.h"
+
+namespace potential {
+
+using particle::Orientation;
+using shared_types::distT;
+using shared_types::eneT;
+using shared_types::vecT;
+using std::vector;
+
+/** Particle pairs gathered for evaluation with one kernel
+ *
+ * Separations and patch vectors are stored component-wise so that batch
+ * kernels can evaluate all pairs with Eigen array (packet) operations.
+ * Only pairs within the kernel cutoff should be added.
+ */
+struct PairBatch {
+    vector<distT> rdist;
+    vector<distT> diff[3];
+    vector<distT> norm1[3];
+    vector<distT> norm2[3];
+    vector<distT> orient1[3];
+    vector<distT> orient2[3];
+    vector<distT> second_orient1[3];
+    vector<distT> second_orient2[3];
+
+    // Work space for intermediate values
+    vector<distT> work[10];
+
+    void add_pair(
+            distT pair_rdist,
+            const vecT& p_diff,
+            const Orientation& ore1,
+            const Orientation& ore2);
+    void clear();
+    int size();
+};
+
+/** Check if a batched version of the kernel is available */
+bool kernel_batchable(const PotentialKernel& kernel);
+
+/** Sum of pair potentials over batch with the batched kernel
+ *
+ * Kernels without a batched version must not be passed.
+ */
+eneT calc_batch_energy(const PotentialKernel& kernel, PairBatch& batch);
+
+eneT calc_batch_energy(const ShiftedLJKernel& kernel, PairBatch& batch);
+
+template<int num_dihedrals>
+eneT calc_batch_energy(
+        const PatchyKernelT<num_dihedrals>& kernel,
+        PairBatch& batch);
+} // namespace potential
+
+#endif // POTENTIAL_BATCH_H
@@ -0,0 +1,335 @@
+// potential_kernel.h
+
+#ifndef POTENTIAL_KERNEL_H
+#define POTENTIAL_KERNEL_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <variant>
+
+#include "BlobCrystallinOligomer/particle.h"
+#include "BlobCrystallinOligomer/shared_types.h"
+
+namespace potential {
+
+using particle::Orientation;
+using shared_types::distT;
+using shared_types::eneT;
+using shared_types::inf;
+using shared_types::vecT;
+
+/** Inline pair potential kernels
+ *
+ * Value types equivalent to the PairPotential classes, which remain the
+ * reference implementation. Composite kernels check the cutoff once and
+ * apply their angular factors in a single pass, and the closed set of
+ * kernels is dispatched through a variant rather than virtual calls.
+ *
+ * Kernels with angular terms may use fast approximations of acos and exp.
+ * Their maximum absolute errors are listed below; test_potential checks the
+ * resulting energy error.
+ */
+
+/** Maximum absolute error of fast_acos (Abramowitz and Stegun 4.4.46) */
+constexpr distT fast_acos_max_error {3e-8};
+
+/** Maximum relative error of fast_exp */
+constexpr distT fast_exp_max_error {1e-9};
+
+/** Polynomial approximation of acos on [-1, 1] */
+inline distT fast_acos(distT x) {
+    distT ax {std::fabs(x)};
+    distT poly {-0.0012624911};
+    poly = poly * ax + 0.0066700901;
+    poly = poly * ax - 0.0170881256;
+    poly = poly * ax + 0.0308918810;
+    poly = poly * ax - 0.0501743046;
+    poly = poly * ax + 0.0889789874;
+    poly = poly * ax - 0.2145988016;
+    poly = poly * ax + 1.5707963050;
+    distT theta {std::sqrt(1 - ax) * poly};
+
+    return x < 0 ? M_PI - theta : theta;
+}
+
+/** Exponential by reduction to 2^k exp(r) with |r| <= ln(2) / 2
+ *
+ * Arguments below -700 return zero. Arguments above 709, where 2^k would
+ * overflow, and NaN are passed to std::exp.
+ */
+inline eneT fast_exp(eneT x) {
+    if (x < -700) {
+        return 0;
+    }
+    if (x > 709 or std::isnan(x)) {
+        return std::exp(x);
+    }
+    eneT k {std::floor(x * M_LOG2E + 0.5)};
+    eneT r {x - k * 6.93145751953125e-1 - k * 1.42860682030941723212e-6};
+    eneT poly {1.0 / 362880};
+    poly = poly * r + 1.0 / 40320;
+    poly = poly * r + 1.0 / 5040;
+    poly = poly * r + 1.0 / 720;
+    poly = poly * r + 1.0 / 120;
+    poly = poly * r + 1.0 / 24;
+    poly = poly * r + 1.0 / 6;
+    poly = poly * r + 1.0 / 2;
+    poly = poly * r + 1;
+    poly = poly * r + 1;
+    std::int64_t bits {(static_cast<std::int64_t>(k) + 1023) << 52};
+    eneT scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+
+    return poly * scale;
+}
+
+/** Gaussian with precalculated 2 sig^2 */
+inline eneT kernel_gaussian(distT theta, distT two_sig2, bool fast_math) {
+    eneT x {-(theta * theta) / two_sig2};
+
+    return fast_math ? fast_exp(x) : std::exp(x);
+}
+
+/** Angle from a cosine clamped against rounding outside [-1, 1] */
+inline distT kernel_angle(distT dot, bool fast_math) {
+    if (dot > 1) {
+        dot = 1;
+    }
+    if (dot < -1) {
+        dot = -1;
+    }
+
+    return fast_math ? fast_acos(dot) : std::acos(dot);
+}
+
+/** Dihedral angle between two patch vectors about the unit separation */
+inline distT kernel_dihedral(
+        const vecT& ore1,
+        const vecT& ore2,
+        const vecT& p_diff_unit,
+        bool fast_math) {
+
+    vecT rej1 {ore1 - ore1.dot(p_diff_unit) * p_diff_unit};
+    vecT rej2 {ore2 - ore2.dot(p_diff_unit) * p_diff_unit};
+
+    return kernel_angle(
+            rej1.dot(rej2) / (rej1.norm() * rej2.norm()), fast_math);
+}
+
+struct ZeroKernel {
+    distT rcut {0};
+
+    eneT operator()(distT, const vecT&, const Orientation&, const Orientation&)
+            const {
+        return 0;
+    }
+};
+
+struct HardSphereKernel {
+    distT rcut;
+
+    HardSphereKernel(distT sigh): rcut {sigh} {}
+
+    eneT operator()(
+            distT rdist,
+            const vecT&,
+            const Orientation&,
+            const Orientation&) const {
+        return rdist < rcut ? inf : 0;
+    }
+};
+
+struct SquareWellKernel {
+    distT rcut;
+    eneT eps;
+
+    SquareWellKernel(eneT eps, distT rcut): rcut {rcut}, eps {eps} {}
+
+    eneT operator()(
+            distT rdist,
+            const vecT&,
+            const Orientation&,
+            const Orientation&) const {
+        return rdist < rcut ? eps : 0;
+    }
+};
+
+struct HarmonicWellKernel {
+    distT rcut;
+    eneT eps;
+    distT a; // steepness parameter
+
+    HarmonicWellKernel(eneT eps, distT rcut):
+            rcut {rcut}, eps {eps}, a {eps / (rcut * rcut)} {}
+
+    eneT operator()(
+            distT rdist,
+            const vecT&,
+            const Orientation&,
+            const Orientation&) const {
+        return rdist < rcut ? a * rdist * rdist - eps : 0;
+    }
+};
+
+struct AngularHarmonicWellKernel {
+    HarmonicWellKernel hwell;
+    distT rcut;
+    distT two_siga2;
+    bool fast_math {false};
+
+    AngularHarmonicWellKernel(eneT eps, distT rcut, distT siga):
+            hwell {eps, rcut}, rcut {rcut}, two_siga2 {2 * siga * siga} {}
+
+    eneT operator()(
+            distT rdist,
+            const vecT& p_diff,
+            const Orientation& ore1,
+            const Orientation& ore2) const {
+
+        eneT ene {hwell(rdist, p_diff, ore1, ore2)};
+        if (ene == 0) {
+            return ene;
+        }
+        distT theta {
+                kernel_angle(ore1.patch_norm.dot(ore2.patch_norm), fast_math)};
+
+        return ene * kernel_gaussian(theta, two_siga2, fast_math);
+    }
+};
+
+struct ShiftedLJKernel {
+    distT rcut;
+    eneT four_eps;
+    distT sigl;
+    eneT shift;
+
+    ShiftedLJKernel(eneT eps, distT sigl, distT rcut):
+            rcut {rcut}, four_eps {4 * eps}, sigl {sigl} {
+        shift = 0;
+        shift = radial(rcut);
+    }
+
+    /** Unshifted value, valid within the cutoff */
+    eneT radial(distT rdist) const {
+        distT sig_r_ratio {sigl / rdist};
+        distT sig_r_ratio2 {sig_r_ratio * sig_r_ratio};
+        distT sig_r_ratio6 {sig_r_ratio2 * sig_r_ratio2 * sig_r_ratio2};
+
+        return four_eps * (sig_r_ratio6 * sig_r_ratio6 - sig_r_ratio6) - shift;
+    }
+
+    eneT operator()(
+            distT rdist,
+            const vecT&,
+            const Orientation&,
+            const Orientation&) const {
+        return rdist < rcut ? radial(rdist) : 0;
+    }
+};
+
+/** Patchy kernels with zero, one or two dihedral terms */
+template<int num_dihedrals>
+struct PatchyKernelT {
+    ShiftedLJKernel lj;
+    distT rcut;
+    distT sigl;
+    distT two_siga1_2;
+    distT two_siga2_2;
+    distT two_sigt2;
+    bool fast_math {false};
+
+    PatchyKernelT(
+            eneT eps,
+            distT sigl,
+            distT rcut,
+            distT siga1,
+            distT siga2,
+            distT sigt = 1):
+            lj {eps, sigl, rcut},
+            rcut {rcut},
+            sigl {sigl},
+            two_siga1_2 {2 * siga1 * siga1},
+            two_siga2_2 {2 * siga2 * siga2},
+            two_sigt2 {2 * sigt * sigt} {}
+
+    eneT operator()(
+            distT rdist,
+            const vecT& p_diff,
+            const Orientation& ore1,
+            const Orientation& ore2) const {
+
+        if (rdist >= rcut) {
+            return 0;
+        }
+        eneT ene {lj.radial(rdist)};
+        if (rdist < sigl or ene == 0) {
+            return ene;
+        }
+        vecT p_diff_unit {p_diff / rdist};
+        distT theta1 {
+                kernel_angle(p_diff_unit.dot(ore1.patch_norm), fast_math)};
+        distT theta2 {
+                kernel_angle(-p_diff_unit.dot(ore2.patch_norm), fast_math)};
+        ene *= kernel_gaussian(theta1, two_siga1_2, fast_math);
+        ene *= kernel_gaussian(theta2, two_siga2_2, fast_math);
+        if (ene == 0) {
+            return 0;
+        }
+        if constexpr (num_dihedrals > 0) {
+            distT theta {kernel_dihedral(
+                    ore1.patch_orient,
+                    ore2.patch_orient,
+                    p_diff_unit,
+                    fast_math)};
+            ene *= kernel_gaussian(theta, two_sigt2, fast_math);
+        }
+        if constexpr (num_dihedrals > 1) {
+            distT theta {kernel_dihedral(
+                    ore1.patch_orient2,
+                    ore2.patch_orient2,
+                    p_diff_unit,
+                    fast_math)};
+            ene *= kernel_gaussian(theta, two_sigt2, fast_math);
+        }
+
+        return ene;
+    }
+};
+
+using PatchyKernel = PatchyKernelT<0>;
+using OrientedPatchyKernel = PatchyKernelT<1>;
+using DoubleOrientedPatchyKernel = PatchyKernelT<2>;
+
+/** Closed set of pair potential kernels */
+using PotentialKernel = std::variant<
+        ZeroKernel,
+        HardSphereKernel,
+        SquareWellKernel,
+        HarmonicWellKernel,
+        AngularHarmonicWellKernel,
+        ShiftedLJKernel,
+        PatchyKernel,
+        OrientedPatchyKernel,
+        DoubleOrientedPatchyKernel>;
+
+/** Calculate pair potential with the given kernel */
+inline eneT calc_kernel_energy(
+        const PotentialKernel& kernel,
+        distT rdist,
+        const vecT& p_diff,
+        const Orientation& ore1,
+        const Orientation& ore2) {
+
+    return std::visit(
+            [&](const auto& kern) { return kern(rdist, p_diff, ore1, ore2); },
+            kernel);
+}
+
+/** Distance at and beyond which the kernel is zero */
+inline distT get_kernel_rcut(const PotentialKernel& kernel) {
+    return std::visit([](const auto& kern) { return kern.rcut; }, kernel);
+}
+} // namespace potential
+
+#endif // POTENTIAL_KERNEL_H
@@ -3,6 +3,9 @@
 #ifndef SIMULATION_H
 #define SIMULATION_H
 
+#include <chrono>
+#include <fstream>
+#include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
@@ -19,18 +22,49 @@ namespace simulation {
 
 using config::Config;
 using energy::Energy;
+using energy::PotentialTable;
 using movetype::MCMovetype;
-using ofile::PatchOutputFile;
-using ofile::VTFOutputFile;
+using ofile::TrajectoryWriter;
 using param::InputParams;
 using random_gens::RandomGens;
+using shared_types::distT;
 using shared_types::eneT;
 using shared_types::stepT;
 using shared_types::timeT;
+using std::ostream;
+using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
 using std::vector;
 
+/** Integrated autocorrelation time of a series in units of its spacing
+ *
+ * The normalized autocorrelation function is summed up to the first lag at
+ * which it is not positive. Returns NaN for series with fewer than two
+ * values or no variance.
+ */
+double calc_autocorrelation_time(const vector<double>& series);
+
+/** Running sum of energy changes
+ *
+ * Uses Neumaier compensated summation so that rounding errors from many
+ * small changes do not accumulate.
+ */
+class RunningEnergy {
+  public:
+    RunningEnergy(eneT ene);
+
+    void add(eneT de);
+    eneT get_total();
+
+    /** Replace the total, e.g. with a full recalculation */
+    void reset(eneT ene);
+
+  private:
+    eneT m_sum;
+    eneT m_compensation {0};
+};
+
 /** Simulation interface */
 class MCSimulation {
   public:
@@ -41,21 +75,53 @@ class MCSimulation {
 // Eventually migrate much of this to a more general class if other simulation
 // method classes are to be designed
 
-/** Canonical ensemble simulation */
+/** Canonical ensemble simulation
+ *
+ * Over the first tune_steps steps, the maximum displacements of each
+ * movetype are scaled by its acceptance ratio over the target after every
+ * tune_interval attempts of it (by a factor of at most two). They are then
+ * fixed for the rest of the run and written to the log.
+ *
+ * Over the following schedule_steps steps, the wall time and accepted squared
+ * displacement of monomer centers of each movetype are measured. The
+ * movetype probabilities are then fixed for the rest of the run in
+ * proportion to the given probabilities times the accepted squared
+ * displacement per second relative to the mean, which is at least a tenth so
+ * that every movetype remains.
+ */
 class NVTMCSimulation {
   public:
     NVTMCSimulation(
             Config& conf,
             Energy& ene,
             InputParams params,
-            RandomGens& random_num);
+            RandomGens& random_num,
+            ostream& log = std::cout);
     void run();
 
-  private:
+    /** Run steps first_step to first_step + num_steps - 1
+     *
+     * Does not check the maximum duration or log a summary.
+     */
+    void run_steps(stepT first_step, stepT num_steps);
+
+    /** Set temperature of simulation and all movetypes */
+    void set_temp(eneT temp);
+
+    /** Running total energy */
+    eneT get_energy();
+
+    /** Recalculate total energy and report drift of running total */
+    void check_energy(stepT step);
+    void log_summary();
+
+  protected:
     Config& m_config;
     Energy& m_energy;
     RandomGens& m_random_num;
+    ostream& m_log;
     eneT m_beta;
+    RunningEnergy m_total_ene;
 
     vector<unique_ptr<MCMovetype>> m_movetypes;
     vector<double> m_cum_probs;
@@ -64,21 +130,117 @@ class NVTMCSimulation {
 
     stepT m_steps;
     timeT m_duration;
+    stepT m_energy_check_freq;
     stepT m_logging_freq;
     stepT m_config_output_freq;
     stepT m_op_output_freq;
 
-    VTFOutputFile m_vtf_file;
-    PatchOutputFile m_patch_file;
-    VTFOutputFile m_pipe_vtf_file;
-    PatchOutputFile m_pipe_patch_file;
+    // Displacement tuning
+    stepT m_tune_steps;
+    stepT m_tune_interval;
+    double m_tune_target_accept;
+    vector<stepT> m_tune_attempts; // Since last tuning of movetype
+    vector<stepT> m_tune_accepts;
+
+    // Movetype scheduling
+    stepT m_schedule_steps;
+    vector<double> m_schedule_times;
+    vector<distT> m_schedule_disp2s;
+    vector<stepT> m_schedule_attempts;
+
+    // Performance measures for the run summary
+    std::chrono::steady_clock::time_point m_start_time;
+    stepT m_steps_run {0};
+    stepT m_sample_freq; // Steps per sweep
+    vector<eneT> m_ene_samples;
+
+    unique_ptr<TrajectoryWriter> m_traj_writer; // Only with config output
 
     void construct_movetypes(InputParams params);
     void setup_output_files(InputParams params);
     int select_movetype();
+    void run_step(stepT step);
+    void tune_movetype(int movetype_i, bool accepted);
+    void log_amplitudes();
+
+    /** Set movetype probabilities from measured costs */
+    void schedule_movetypes();
+    double get_movetype_prob(int movetype_i);
     void log_move(stepT step, string movetype_label, bool accepted);
+};
+
+/** Parallel tempering (replica exchange) over temperatures
+ *
+ * Each replica is a canonical simulation with its own configuration, energy
+ * and random number generators, while all share one potential table. The
+ * replicas are run on a team of threads between exchanges, where swaps of
+ * neighbouring temperatures are attempted. Replica output files are
+ * suffixed with the replica index and follow the replica rather than the
+ * temperature. Energy checks and move summaries of each replica are written
+ * to <filebase>-replica-<i>.log, and exchanges are logged by this class.
+ */
+class PTMCSimulation {
+  public:
+    PTMCSimulation(InputParams params);
+    void run();
+
+  private:
+    vector<eneT> m_temps; // Increasing
+    vector<unique_ptr<RandomGens>> m_random_nums;
+    vector<unique_ptr<Config>> m_configs;
+    vector<unique_ptr<Energy>> m_energies;
+    vector<unique_ptr<std::ofstream>> m_logs;
+    vector<unique_ptr<NVTMCSimulation>> m_replicas;
+    RandomGens m_random_num; // For exchanges
+
+    vector<int> m_temp_replicas; // Replica at each temperature
+    long m_exchanges {0};
+
+    // Swap attempts and accepts between each temperature and the next
+    vector<stepT> m_swap_attempts;
+    vector<stepT> m_swap_accepts;
+
+    stepT m_steps;
+    timeT m_duration;
+    stepT m_exchange_freq;
+    stepT m_energy_check_freq;
+    stepT m_logging_freq;
+    int m_num_threads;
+
+    /** Attempt swaps between neighbouring temperatures
+     *
+     * Alternates between the even and odd pairs of temperatures.
+     */
+    void attempt_exchanges();
+    void log_exchange(stepT step);
     void log_summary();
 };
+
+/** Independent canonical simulations of an ensemble of parameter sets
+ *
+ * Each parameter set is run for a number of reps, each with its own
+ * configuration, energy, random number generators and output filebase
+ * (suffixed with _rep-<rep>-<set>). Logs are written to <filebase>.log
+ * rather than standard output. Reps of a parameter set share one potential
+ * table. Reps are run on a team of threads, each taking the next waiting rep
+ * as soon as it finishes its last.
+ */
+class EnsembleMCSimulation {
+  public:
+    EnsembleMCSimulation(
+            vector<string> param_filenames,
+            int reps,
+            int num_threads);
+    void run();
+
+  private:
+    vector<InputParams> m_params;
+    vector<shared_ptr<const PotentialTable>> m_tables;
+    int m_reps;
+    int m_num_threads;
+
+    void run_rep(int params_i, int rep);
+};
 } // namespace simulation
 
 #endif // SIMULATION_H
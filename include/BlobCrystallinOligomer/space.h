@@ -3,12 +3,17 @@
 #ifndef SPACE_H
 #define SPACE_H
 
+#include <array>
+#include <vector>
+
 #include "BlobCrystallinOligomer/shared_types.h"
 
 namespace space {
 
 using shared_types::distT;
 using shared_types::vecT;
+using std::array;
+using std::vector;
 
 class CuboidPBC {
   public:
@@ -31,6 +36,100 @@ class CuboidPBC {
   private:
     distT m_r;
 };
+
+/** Cell list spatial index for a cubic box with PBC
+ *
+ * The box is divided into cubic cells that are at least as wide as the given
+ * minimum length, so that every item within that distance of a position is in
+ * the cell containing the position or one of the adjacent cells. If fewer than
+ * three cells fit along a side, a single cell is used.
+ */
+class CellList {
+  public:
+    CellList();
+    virtual ~CellList() {}
+
+    /** Create empty cells for the given box and number of items */
+    void setup(distT box_len, distT min_cell_len, int num_items);
+
+    /** Place item at given position, removing it from its old cell */
+    virtual void update(int item_i, vecT pos);
+
+    /** Get all items in the cell containing the position and adjacent cells */
+    vector<int> get_neighbours(vecT pos);
+
+    int get_cells_per_side();
+
+    /** Get indices along each axis of the cell containing the position */
+    array<int, 3> calc_cell_coors(vecT& pos);
+
+  private:
+    distT m_box_len {0};
+    distT m_cell_len {0};
+    int m_cells_per_side {1};
+    vector<vector<int>> m_cell_items {};
+    vector<vector<int>> m_adjacent_cells {}; // Including the cell itself
+    vector<int> m_item_cell {}; // -1 if item not placed
+    vector<int> m_item_slot {}; // Position of item in its cell's item list
+
+    int calc_cell(vecT& pos);
+};
+
+/** Cell list with an optional Verlet list for each item
+ *
+ * Each item's list holds the other items within the interaction length plus
+ * a skin at the time the lists were built. The lists stay complete until some
+ * item has moved more than half the skin from where it was then, after which
+ * they are rebuilt on the next query. With no skin only the cells are used.
+ */
+class VerletList: public CellList {
+  public:
+    VerletList(CuboidPBC& pbc_space);
+
+    /** Create empty cells and lists for the given box and number of items */
+    void setup(
+            distT box_len,
+            distT interaction_len,
+            distT skin,
+            int num_items);
+
+    /** Place item at given position and check if lists need rebuilding */
+    void update(int item_i, vecT pos) override;
+
+    /** Get items that may be within the interaction length of the item
+     *
+     * The position may differ from the item's stored position (e.g., a trial
+     * position). If it is too far from where the item was when the lists
+     * were built, the cells are used instead. The item itself is only
+     * excluded when the list is used.
+     */
+    vector<int> get_item_neighbours(int item_i, vecT pos);
+
+    /** Rebuild the lists if any item has moved too far */
+    void update_lists();
+
+    /** Use only the cells until resumed
+     *
+     * Updates then only write the item's own entries, so that items far
+     * enough apart may be updated and queried from different threads.
+     */
+    void suspend_lists();
+
+    /** Use the lists again, checking if they need rebuilding */
+    void resume_lists();
+
+  private:
+    CuboidPBC& m_space;
+    distT m_list_len {0}; // Interaction length plus skin
+    distT m_skin {0};
+    bool m_stale {true};
+    bool m_suspended {false};
+    vector<vecT> m_pos {};
+    vector<vecT> m_ref_pos {}; // Positions when lists were built
+    vector<vector<int>> m_lists {};
+
+    void build_lists();
+};
 } // namespace space
 
 #endif // SPACE_H
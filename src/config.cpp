@@ -1,5 +1,7 @@
 // config.cpp
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -8,6 +10,7 @@
 
 namespace config {
 
+using shared_types::inf;
 using std::cout;
 using std::make_unique;
 using std::pair;
@@ -15,7 +18,10 @@ using std::pair;
 Config::Config(InputParams& params, RandomGens& random_num):
         m_space_store {new CuboidPBC()},
         m_space {*m_space_store},
-        m_random_num {random_num} {
+        m_cells {m_space},
+        m_random_num {random_num},
+        m_max_cutoff {params.m_max_cutoff},
+        m_verlet_skin {params.m_verlet_skin} {
 
     InputConfigFile config_file {params.m_config_filename};
     m_box_len = config_file.get_box_len();
@@ -28,6 +34,7 @@ Config::Config(InputParams& params, RandomGens& random_num):
     for (auto& m: m_monomers) {
         m_monomer_refs.emplace_back(*m);
     }
+    fill_cells();
 }
 
 Config::Config(
@@ -35,11 +42,23 @@ Config::Config(
         RandomGens& random_num,
         distT box_len,
         distT radius):
+        Config {monomers, random_num, box_len, radius, inf, 0} {}
+
+Config::Config(
+        vector<MonomerData> monomers,
+        RandomGens& random_num,
+        distT box_len,
+        distT radius,
+        distT max_cutoff,
+        distT verlet_skin):
         m_space_store {new CuboidPBC()},
         m_space {*m_space_store},
+        m_cells {m_space},
         m_random_num {random_num},
         m_box_len {box_len},
-        m_radius {radius} {
+        m_radius {radius},
+        m_max_cutoff {max_cutoff},
+        m_verlet_skin {verlet_skin} {
 
     m_space.set_len(m_box_len);
     create_monomers(monomers);
@@ -48,6 +67,7 @@ Config::Config(
     for (auto& m: m_monomers) {
         m_monomer_refs.emplace_back(*m);
     }
+    fill_cells();
 }
 
 Monomer& Config::get_monomer(int monomer_index) {
@@ -59,8 +79,71 @@ Monomer& Config::get_random_monomer() {
     return *m_monomers[m_i];
 }
 
+namespace {
+
+/** Spread the lower 21 bits of x to every third bit */
+std::uint64_t spread_bits(std::uint64_t x) {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffff;
+    x = (x | x << 16) & 0x1f0000ff0000ff;
+    x = (x | x << 8) & 0x100f00f00f00f00f;
+    x = (x | x << 4) & 0x10c30c30c30c30c3;
+    x = (x | x << 2) & 0x1249249249249249;
+
+    return x;
+}
+} // namespace
+
+vector<int> Config::calc_spatial_order() {
+    vector<pair<std::uint64_t, int>> keys {};
+    for (auto& monomer: m_monomers) {
+        vecT center {monomer->get_center(CoorSet::current)};
+        array<int, 3> cell {calc_cell_coors(center)};
+        std::uint64_t key {
+                spread_bits(cell[0]) | spread_bits(cell[1]) << 1 |
+                spread_bits(cell[2]) << 2};
+        keys.emplace_back(key, monomer->get_index());
+    }
+    std::sort(keys.begin(), keys.end());
+    vector<int> order {};
+    for (auto& key: keys) {
+        order.push_back(key.second);
+    }
+
+    return order;
+}
+
 monomerArrayT Config::get_monomers() { return m_monomer_refs; }
 
+ParticleStore& Config::get_particle_store() { return m_particle_store; }
+
+monomerArrayT Config::get_monomer_neighbours(
+        Monomer& monomer,
+        CoorSet coorset) {
+    monomerArrayT neighbours {};
+    int monomer_i {monomer.get_index()};
+    vecT center {monomer.get_center(coorset)};
+    for (int i: m_cells.get_item_neighbours(monomer_i, center)) {
+        if (i != monomer_i) {
+            neighbours.emplace_back(*m_monomers[i]);
+        }
+    }
+
+    return neighbours;
+}
+
+void Config::update_neighbour_lists() { m_cells.update_lists(); }
+
+void Config::suspend_neighbour_lists() { m_cells.suspend_lists(); }
+
+void Config::resume_neighbour_lists() { m_cells.resume_lists(); }
+
+int Config::get_cells_per_side() { return m_cells.get_cells_per_side(); }
+
+array<int, 3> Config::calc_cell_coors(vecT pos) {
+    return m_cells.calc_cell_coors(pos);
+}
+
 int Config::get_num_particles() {
     int num_parts {0};
     for (Monomer& mono: m_monomer_refs) {
@@ -76,6 +159,8 @@ distT Config::get_box_len() { return m_box_len; }
 
 distT Config::get_radius() { return m_radius; }
 
+distT Config::get_interaction_len() { return m_interaction_len; }
+
 vecT Config::calc_interparticle_vector(
         Particle& particle1,
         CoorSet coorset1,
@@ -100,6 +185,10 @@ distT Config::calc_dist(
     return m_space.calc_dist(pos1, pos2);
 }
 
+distT Config::calc_dist(vecT& pos1, vecT& pos2) {
+    return m_space.calc_dist(pos1, pos2);
+}
+
 distT Config::calc_dist(
         Monomer& monomer1,
         CoorSet& coorset1,
@@ -124,12 +213,33 @@ void Config::update_config_positions(vector<vector<double>> positions) {
             particle.get().set_pos(pos);
             pos_i++;
         }
+        m_cells.update(
+                monomer.get().get_index(),
+                monomer.get().get_center(CoorSet::current));
     }
 }
 
 void Config::create_monomers(vector<MonomerData> monomers) {
     for (auto m_data: monomers) {
-        m_monomers.emplace_back(make_unique<Monomer>(m_data, m_space));
+        m_monomers.emplace_back(make_unique<Monomer>(
+                m_data, m_space, m_cells, m_particle_store));
+    }
+}
+
+void Config::fill_cells() {
+
+    // Two monomers interact only if their centers are within this distance
+    distT max_monomer_r {0};
+    for (Monomer& mono: m_monomer_refs) {
+        if (mono.get_radius() > max_monomer_r) {
+            max_monomer_r = mono.get_radius();
+        }
+    }
+    m_interaction_len = 2 * max_monomer_r + m_max_cutoff;
+    m_cells.setup(
+            m_box_len, m_interaction_len, m_verlet_skin, m_monomers.size());
+    for (Monomer& mono: m_monomer_refs) {
+        m_cells.update(mono.get_index(), mono.get_center(CoorSet::current));
     }
 }
 } // namespace config
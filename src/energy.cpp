@@ -1,30 +1,42 @@
 // energy.cpp
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
 #include <memory>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "BlobCrystallinOligomer/energy.h"
 
 namespace energy {
 
 using ifile::InputEnergyFile;
 using monomer::particleArrayT;
-using potential::AngularHarmonicWellPotential;
-using potential::DoubleOrientedPatchyPotential;
-using potential::HardSpherePotential;
-using potential::HarmonicWellPotential;
-using potential::OrientedPatchyPotential;
-using potential::PatchyPotential;
-using potential::ShiftedLJPotential;
-using potential::SquareWellPotential;
-using potential::ZeroPotential;
+using particle::Orientation;
+using potential::AngularHarmonicWellKernel;
+using potential::calc_batch_energy;
+using potential::calc_kernel_energy;
+using potential::DoubleOrientedPatchyKernel;
+using potential::get_kernel_rcut;
+using potential::HardSphereKernel;
+using potential::HarmonicWellKernel;
+using potential::kernel_batchable;
+using potential::OrientedPatchyKernel;
+using potential::PatchyKernel;
+using potential::ShiftedLJKernel;
+using potential::SquareWellKernel;
+using potential::ZeroKernel;
 using shared_types::inf;
 using shared_types::InputError;
 using shared_types::vecT;
 using std::cout;
 
-Energy::Energy(Config& conf, InputParams& params):
-        m_config {conf}, m_max_cutoff {params.m_max_cutoff} {
+PotentialTable::PotentialTable(Config& conf, InputParams& params):
+        m_fast_math {params.m_fast_math} {
 
     InputEnergyFile energy_file {params.m_energy_filename};
     vector<PotentialData> potentials {energy_file.get_potentials()};
@@ -33,26 +45,101 @@ Energy::Energy(Config& conf, InputParams& params):
     vector<InteractionData> different_conformers_interactions {
             energy_file.get_different_conformers_interactions()};
     create_potentials(
+            conf,
             potentials,
             same_conformers_interactions,
             different_conformers_interactions);
-    eneT total_ene {calc_total_energy()};
-    if (total_ene == inf or total_ene != total_ene) {
-        cout << "Bad starting configuration\n";
+}
+
+const PairPotentialEntry& PotentialTable::get_pair_potential(
+        int type1,
+        int conformer1,
+        int type2,
+        int conformer2) const {
+
+    int relation {conformer1 != conformer2};
+    const PairPotentialEntry& entry {
+            m_pair_pots[(relation * m_num_types + type1) * m_num_types +
+                        type2]};
+    if (entry.kernel == nullptr) {
+        cout << "No potential for particle types " << type1 << " and "
+             << type2 << "\n";
         throw InputError {};
     }
+
+    return entry;
+}
+
+const PotentialKernel& PotentialTable::get_kernel(int kernel_i) const {
+    return m_kernels[kernel_i];
+}
+
+int PotentialTable::get_num_kernels() const { return m_kernels.size(); }
+
+int PotentialTable::get_num_types() const { return m_num_types; }
+
+distT PotentialTable::get_max_rcut() const {
+    distT max_rcut {0};
+    for (const PotentialKernel& kernel: m_kernels) {
+        max_rcut = std::max(max_rcut, get_kernel_rcut(kernel));
+    }
+
+    return max_rcut;
+}
+
+Energy::Energy(Config& conf, InputParams& params):
+        m_config {conf},
+        m_table {std::make_shared<const PotentialTable>(conf, params)},
+        m_max_cutoff {params.m_max_cutoff},
+        m_num_threads {std::max(params.m_num_threads, 1)} {
+
+    initialize();
+}
+
+Energy::Energy(
+        Config& conf,
+        InputParams& params,
+        shared_ptr<const PotentialTable> table):
+        m_config {conf},
+        m_table {table},
+        m_max_cutoff {params.m_max_cutoff},
+        m_num_threads {std::max(params.m_num_threads, 1)} {
+
+    initialize();
+}
+
+shared_ptr<const PotentialTable> Energy::get_potential_table() {
+    return m_table;
+}
+
+void Energy::set_serial_level() {
+#ifdef _OPENMP
+    m_serial_level = omp_get_level();
+#endif
 }
 
 eneT Energy::calc_total_energy() {
+
+    // Neighbour queries only read once the Verlet lists are up to date
+    m_config.update_neighbour_lists();
     monomerArrayT monomers {m_config.get_monomers()};
+    int num_monomers {m_config.get_num_monomers()};
     eneT total_ene {0};
-    for (size_t i {0}; i != monomers.size() - 1; i++) {
-        Monomer& monomer1 {monomers[i].get()};
-        for (size_t j {i + 1}; j != monomers.size(); j++) {
-            Monomer& monomer2 {monomers[j].get()};
-            total_ene += calc_monomer_pair_energy(
-                    monomer1, CoorSet::current, monomer2, CoorSet::current);
+    std::exception_ptr error {};
+#pragma omp parallel for num_threads(m_num_threads) schedule(dynamic, 16) \
+        reduction(+ : total_ene)
+    for (int i = 0; i < num_monomers; i++) {
+        try {
+            total_ene += calc_upper_pair_energies(
+                    monomers[i], get_thread_batch_set());
         }
+        catch (...) {
+#pragma omp critical
+            error = std::current_exception();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
     }
 
     return total_ene;
@@ -64,24 +151,53 @@ eneT Energy::calc_monomer_pair_energy(
         Monomer& monomer2,
         CoorSet coorset2) {
 
+    return calc_monomer_pair_energy(
+            monomer1, coorset1, monomer2, coorset2, get_thread_batch_set());
+}
+
+eneT Energy::calc_monomer_pair_energy(
+        Monomer& monomer1,
+        CoorSet coorset1,
+        Monomer& monomer2,
+        CoorSet coorset2,
+        PairBatchSet& batch_set) {
+
     eneT pair_ene {0};
+    int conformer1 {monomer1.get_conformer(coorset1)};
+    int conformer2 {monomer2.get_conformer(coorset2)};
     particleArrayT particles1 {monomer1.get_particles()};
     particleArrayT particles2 {monomer2.get_particles()};
     for (Particle& p1: particles1) {
         for (Particle& p2: particles2) {
-            eneT part_ene {calc_particle_pair_energy(
-                    p1,
-                    monomer1.get_conformer(coorset1),
-                    coorset1,
-                    p2,
-                    monomer2.get_conformer(coorset2),
-                    coorset2)};
+            const PairPotentialEntry& entry {
+                    get_pair_potential(p1, conformer1, p2, conformer2)};
+            vecT diff {m_config.calc_interparticle_vector(
+                    p2, coorset2, p1, coorset1)};
+            distT dist2 {diff.squaredNorm()};
+            if (dist2 >= entry.rcut2) {
+                continue;
+            }
+            distT dist {std::sqrt(dist2)};
+            Orientation& p1_ore {p1.get_ore(coorset1)};
+            Orientation& p2_ore {p2.get_ore(coorset2)};
+            if (entry.batch_i != -1) {
+                PairBatch& batch {batch_set.batches[entry.batch_i]};
+                if (batch.size() == 0) {
+                    batch_set.filled.push_back(entry.batch_i);
+                }
+                batch.add_pair(dist, diff, p1_ore, p2_ore);
+                continue;
+            }
+            eneT part_ene {calc_kernel_energy(
+                    *entry.kernel, dist, diff, p1_ore, p2_ore)};
             if (part_ene == inf) {
+                clear_batches(batch_set);
                 return inf;
             }
             pair_ene += part_ene;
         }
     }
+    pair_ene += calc_batch_energies(batch_set);
 
     return pair_ene;
 }
@@ -139,14 +255,12 @@ monomerArrayT Energy::get_interacting_monomers(
         Monomer& monomer1,
         CoorSet coorset1) {
 
-    monomerArrayT monomers {m_config.get_monomers()};
+    monomerArrayT monomers {
+            m_config.get_monomer_neighbours(monomer1, coorset1)};
     monomerArrayT interacting_monomers {};
     CoorSet coorset2 {CoorSet::current};
     for (size_t i {0}; i != monomers.size(); i++) {
         Monomer& monomer2 {monomers[i].get()};
-        if (monomer1.get_index() == monomer2.get_index()) {
-            continue;
-        }
         if (monomers_interacting(monomer1, coorset1, monomer2, coorset2)) {
             interacting_monomers.push_back(monomer2);
         }
@@ -156,21 +270,95 @@ monomerArrayT Energy::get_interacting_monomers(
 }
 
 eneT Energy::calc_monomer_diff(Monomer& mono1) {
-    monomerArrayT monos {m_config.get_monomers()};
-    eneT de {0};
-    for (size_t i {0}; i != monos.size(); i++) {
-        Monomer& mono2 {monos[i].get()};
-        if (mono1.get_index() == mono2.get_index()) {
-            continue;
-        }
-        eneT ene1 {calc_monomer_pair_energy(
-                mono1, CoorSet::current, mono2, CoorSet::current)};
-        eneT ene2 {calc_monomer_pair_energy(
+    int mi1 {mono1.get_index()};
+    eneT ene1 {0};
+    for (auto& p_ene: m_pair_enes[mi1]) {
+        ene1 += p_ene.second;
+    }
+
+    // Monomers outside the neighbouring cells contribute nothing
+    vector<pair<int, eneT>>& trial_enes {m_trial_pair_enes[mi1]};
+    trial_enes.clear();
+    m_trial_pair_enes_commit[mi1] = -1;
+    monomerArrayT trial_monos {
+            m_config.get_monomer_neighbours(mono1, CoorSet::trial)};
+    eneT ene2 {0};
+    for (size_t i {0}; i != trial_monos.size(); i++) {
+        Monomer& mono2 {trial_monos[i].get()};
+        eneT ene {calc_monomer_pair_energy(
                 mono1, CoorSet::trial, mono2, CoorSet::current)};
-        de += ene2 - ene1;
+        if (ene == inf) {
+            return inf;
+        }
+        if (ene != 0) {
+            trial_enes.emplace_back(mono2.get_index(), ene);
+        }
+        ene2 += ene;
+    }
+    m_trial_pair_enes_commit[mi1] = get_thread_commits();
+
+    return ene2 - ene1;
+}
+
+eneT Energy::get_pair_energy(Monomer& monomer1, Monomer& monomer2) {
+    unordered_map<int, eneT>& pair_enes {m_pair_enes[monomer1.get_index()]};
+    auto p_ene {pair_enes.find(monomer2.get_index())};
+    if (p_ene == pair_enes.end()) {
+        return 0;
+    }
+
+    return p_ene->second;
+}
+
+eneT Energy::trial_to_current(Monomer& monomer) {
+    int mi {monomer.get_index()};
+    monomer.trial_to_current();
+    eneT ene1 {clear_pair_energies(mi)};
+    eneT ene2 {0};
+    long& commits {get_thread_commits()};
+    if (m_trial_pair_enes_commit[mi] == commits) {
+        for (auto& p_ene: m_trial_pair_enes[mi]) {
+            set_pair_energy(mi, p_ene.first, p_ene.second);
+            ene2 += p_ene.second;
+        }
+    }
+    else {
+        ene2 = calc_pair_energies(monomer);
     }
+    m_trial_pair_enes_commit[mi] = -1;
+    commits += m_num_threads;
 
-    return de;
+    return ene2 - ene1;
+}
+
+void Energy::keep_trial_pair_energies(Monomer& monomer) {
+    long& commit {m_trial_pair_enes_commit[monomer.get_index()]};
+    if (commit != -1) {
+        commit = get_thread_commits();
+    }
+}
+
+eneT Energy::trial_to_current(monomerArrayT& monomers) {
+    eneT ene1 {0};
+    for (Monomer& monomer: monomers) {
+        monomer.trial_to_current();
+        ene1 += clear_pair_energies(monomer.get_index());
+    }
+
+    // Rotations unwrap about the rotation center, so pairs within a cluster
+    // spanning the box are not rigid and must be recalculated as well
+    eneT ene2 {0};
+    for (Monomer& monomer: monomers) {
+        ene2 += calc_pair_energies(monomer);
+        m_recalculated[monomer.get_index()] = true;
+    }
+    for (Monomer& monomer: monomers) {
+        m_recalculated[monomer.get_index()] = false;
+        m_trial_pair_enes_commit[monomer.get_index()] = -1;
+    }
+    get_thread_commits() += m_num_threads;
+
+    return ene2 - ene1;
 }
 
 bool Energy::particles_interacting(
@@ -181,16 +369,11 @@ bool Energy::particles_interacting(
         int conformer2,
         CoorSet coorset2) {
 
-    distT dist {m_config.calc_dist(particle1, coorset1, particle2, coorset2)};
-    pair<int, int> key {particle1.get_type(), particle2.get_type()};
-    PairPotential* pot;
-    if (conformer1 == conformer2) {
-        pot = &(m_same_pair_to_pot.at(key).get());
-    }
-    else {
-        pot = &(m_different_pair_to_pot.at(key).get());
-    }
-    bool interacting {pot->particles_interacting(dist)};
+    const PairPotentialEntry& entry {
+            get_pair_potential(particle1, conformer1, particle2, conformer2)};
+    vecT diff {m_config.calc_interparticle_vector(
+            particle2, coorset2, particle1, coorset1)};
+    bool interacting {diff.squaredNorm() < entry.rcut2};
 
     return interacting;
 }
@@ -203,97 +386,343 @@ eneT Energy::calc_particle_pair_energy(
         int conformer2,
         CoorSet coorset2) {
 
+    const PairPotentialEntry& entry {
+            get_pair_potential(particle1, conformer1, particle2, conformer2)};
     vecT diff {m_config.calc_interparticle_vector(
             particle2, coorset2, particle1, coorset1)};
-    distT dist {diff.norm()};
-    auto p1_ore {particle1.get_ore(coorset1)};
-    auto p2_ore {particle2.get_ore(coorset2)};
-    pair<int, int> key {particle1.get_type(), particle2.get_type()};
 
-    PairPotential* pot;
-    if (conformer1 == conformer2) {
-        pot = &(m_same_pair_to_pot.at(key).get());
-    }
-    else {
-        pot = &(m_different_pair_to_pot.at(key).get());
+    // Every kernel is zero at and beyond its cutoff
+    distT dist2 {diff.squaredNorm()};
+    if (dist2 >= entry.rcut2) {
+        return 0;
     }
-    eneT ene {pot->calc_energy(dist, diff, p1_ore, p2_ore)};
+    distT dist {std::sqrt(dist2)};
+    Orientation& p1_ore {particle1.get_ore(coorset1)};
+    Orientation& p2_ore {particle2.get_ore(coorset2)};
+    eneT ene {calc_kernel_energy(*entry.kernel, dist, diff, p1_ore, p2_ore)};
 
     return ene;
 }
 
-void Energy::create_potentials(
+void PotentialTable::create_potentials(
+        Config& conf,
         vector<PotentialData> potentials,
         vector<InteractionData> same_conformers_interactions,
         vector<InteractionData> different_conformers_interactions) {
 
     for (auto p_data: potentials) {
-        PairPotential* pot;
         if (p_data.form == "Zero") {
-            pot = new ZeroPotential {};
+            m_kernels.emplace_back(ZeroKernel {});
         }
-        if (p_data.form == "HardSphere") {
-            pot = new HardSpherePotential {p_data.sigh};
+        else if (p_data.form == "HardSphere") {
+            m_kernels.emplace_back(HardSphereKernel {p_data.sigh});
         }
-        if (p_data.form == "SquareWell") {
-            pot = new SquareWellPotential {p_data.eps, p_data.rcut};
+        else if (p_data.form == "SquareWell") {
+            m_kernels.emplace_back(SquareWellKernel {p_data.eps, p_data.rcut});
         }
-        if (p_data.form == "HarmonicWell") {
-            pot = new HarmonicWellPotential {p_data.eps, p_data.rcut};
+        else if (p_data.form == "HarmonicWell") {
+            m_kernels.emplace_back(
+                    HarmonicWellKernel {p_data.eps, p_data.rcut});
         }
-        if (p_data.form == "AngularHarmonicWell") {
-            pot = new AngularHarmonicWellPotential {
+        else if (p_data.form == "AngularHarmonicWell") {
+            AngularHarmonicWellKernel kernel {
                     p_data.eps, p_data.rcut, p_data.siga1};
+            kernel.fast_math = m_fast_math;
+            m_kernels.emplace_back(kernel);
         }
         else if (p_data.form == "ShiftedLJ") {
-            pot = new ShiftedLJPotential {p_data.eps, p_data.sigl, p_data.rcut};
+            m_kernels.emplace_back(
+                    ShiftedLJKernel {p_data.eps, p_data.sigl, p_data.rcut});
         }
         else if (p_data.form == "Patchy") {
-            pot = new PatchyPotential {
+            PatchyKernel kernel {
                     p_data.eps,
                     p_data.sigl,
                     p_data.rcut,
                     p_data.siga1,
                     p_data.siga2};
+            kernel.fast_math = m_fast_math;
+            m_kernels.emplace_back(kernel);
         }
         else if (p_data.form == "OrientedPatchy") {
-            pot = new OrientedPatchyPotential {
+            OrientedPatchyKernel kernel {
                     p_data.eps,
                     p_data.sigl,
                     p_data.rcut,
                     p_data.siga1,
                     p_data.siga2,
                     p_data.sigt};
+            kernel.fast_math = m_fast_math;
+            m_kernels.emplace_back(kernel);
         }
         else if (p_data.form == "DoubleOrientedPatchy") {
-            pot = new DoubleOrientedPatchyPotential {
+            DoubleOrientedPatchyKernel kernel {
                     p_data.eps,
                     p_data.sigl,
                     p_data.rcut,
                     p_data.siga1,
                     p_data.siga2,
                     p_data.sigt};
+            kernel.fast_math = m_fast_math;
+            m_kernels.emplace_back(kernel);
+        }
+        else {
+            cout << "No such potential form " << p_data.form << "\n";
+            throw InputError {};
         }
-        m_potentials.emplace_back(pot);
     }
 
-    for (auto i_data: same_conformers_interactions) {
-        for (auto p_pair: i_data.particle_pairs) {
-            PairPotential& pot {*m_potentials[i_data.potential_index]};
-            m_same_pair_to_pot.emplace(p_pair, pot);
-            pair<int, int> reversed_p_pair {p_pair.second, p_pair.first};
-            m_same_pair_to_pot.emplace(reversed_p_pair, pot);
+    // Table must cover all types in both interactions and configuration
+    for (auto interactions:
+         {same_conformers_interactions, different_conformers_interactions}) {
+        for (auto i_data: interactions) {
+            for (auto p_pair: i_data.particle_pairs) {
+                m_num_types = std::max(m_num_types, p_pair.first + 1);
+                m_num_types = std::max(m_num_types, p_pair.second + 1);
+            }
         }
     }
+    for (Monomer& mono: conf.get_monomers()) {
+        for (Particle& part: mono.get_particles()) {
+            m_num_types = std::max(m_num_types, part.get_type() + 1);
+        }
+    }
+    m_pair_pots.assign(2 * m_num_types * m_num_types, {});
+    add_pair_potentials(same_conformers_interactions, 0);
+    add_pair_potentials(different_conformers_interactions, 1);
+}
+
+void PotentialTable::add_pair_potentials(
+        vector<InteractionData> interactions,
+        int relation) {
 
-    for (auto i_data: different_conformers_interactions) {
+    for (auto i_data: interactions) {
+        int kernel_i {i_data.potential_index};
+        PotentialKernel& kernel {m_kernels[kernel_i]};
+        distT rcut {get_kernel_rcut(kernel)};
+        int batch_i {kernel_batchable(kernel) ? kernel_i : -1};
+        PairPotentialEntry entry {&kernel, rcut * rcut, batch_i};
         for (auto p_pair: i_data.particle_pairs) {
-            PairPotential& pot {*m_potentials[i_data.potential_index]};
-            m_different_pair_to_pot.emplace(p_pair, pot);
-            pair<int, int> reversed_p_pair {p_pair.second, p_pair.first};
-            m_different_pair_to_pot.emplace(reversed_p_pair, pot);
+            int t1 {p_pair.first};
+            int t2 {p_pair.second};
+
+            // The first interaction given for a pair of types is kept
+            int pair_i1 {(relation * m_num_types + t1) * m_num_types + t2};
+            int pair_i2 {(relation * m_num_types + t2) * m_num_types + t1};
+            for (int pair_i: {pair_i1, pair_i2}) {
+                if (m_pair_pots[pair_i].kernel == nullptr) {
+                    m_pair_pots[pair_i] = entry;
+                }
+            }
+        }
+    }
+}
+
+void Energy::initialize() {
+    set_serial_level();
+    for (Monomer& mono: m_config.get_monomers()) {
+        for (Particle& part: mono.get_particles()) {
+            if (part.get_type() >= m_table->get_num_types()) {
+                cout << "No potentials for particle type " << part.get_type()
+                     << "\n";
+                throw InputError {};
+            }
+        }
+    }
+
+    // Cells and neighbour lists only find pairs within the maximum cutoff
+    if (m_table->get_max_rcut() > m_max_cutoff) {
+        cout << "Maximum cutoff " << m_max_cutoff
+             << " is less than the largest potential cutoff "
+             << m_table->get_max_rcut() << "\n";
+        throw InputError {};
+    }
+    m_batch_sets.assign(m_num_threads, {});
+    for (auto& batch_set: m_batch_sets) {
+        batch_set.batches.assign(m_table->get_num_kernels(), {});
+    }
+    for (int i {0}; i != m_num_threads; i++) {
+        m_commits.push_back(i);
+    }
+    fill_pair_energies();
+    eneT total_ene {0};
+    for (auto& pair_enes: m_pair_enes) {
+        for (auto& p_ene: pair_enes) {
+            total_ene += p_ene.second;
         }
     }
+    if (total_ene == inf or total_ene != total_ene) {
+        cout << "Bad starting configuration\n";
+        throw InputError {};
+    }
+}
+
+const PairPotentialEntry& Energy::get_pair_potential(
+        Particle& particle1,
+        int conformer1,
+        Particle& particle2,
+        int conformer2) {
+
+    return m_table->get_pair_potential(
+            particle1.get_type(), conformer1, particle2.get_type(), conformer2);
+}
+
+eneT Energy::calc_batch_energies(PairBatchSet& batch_set) {
+    eneT ene {0};
+    for (int batch_i: batch_set.filled) {
+        ene += calc_batch_energy(
+                m_table->get_kernel(batch_i), batch_set.batches[batch_i]);
+        batch_set.batches[batch_i].clear();
+    }
+    batch_set.filled.clear();
+
+    return ene;
+}
+
+void Energy::clear_batches(PairBatchSet& batch_set) {
+    for (int batch_i: batch_set.filled) {
+        batch_set.batches[batch_i].clear();
+    }
+    batch_set.filled.clear();
+}
+
+int Energy::get_thread_index() {
+#ifdef _OPENMP
+    if (omp_get_level() > m_serial_level) {
+        return omp_get_ancestor_thread_num(m_serial_level + 1);
+    }
+#endif
+    return 0;
+}
+
+PairBatchSet& Energy::get_thread_batch_set() {
+    return m_batch_sets[get_thread_index()];
+}
+
+long& Energy::get_thread_commits() { return m_commits[get_thread_index()]; }
+
+eneT Energy::calc_upper_pair_energies(
+        Monomer& monomer,
+        PairBatchSet& batch_set,
+        vector<pair<int, eneT>>& pair_enes) {
+
+    int mi1 {monomer.get_index()};
+    eneT total_ene {0};
+    for (Monomer& mono2:
+         m_config.get_monomer_neighbours(monomer, CoorSet::current)) {
+        int mi2 {mono2.get_index()};
+        if (mi2 < mi1) {
+            continue;
+        }
+        eneT ene {calc_monomer_pair_energy(
+                monomer,
+                CoorSet::current,
+                mono2,
+                CoorSet::current,
+                batch_set)};
+        if (ene != 0) {
+            pair_enes.emplace_back(mi2, ene);
+        }
+        total_ene += ene;
+    }
+
+    return total_ene;
+}
+
+eneT Energy::calc_upper_pair_energies(
+        Monomer& monomer,
+        PairBatchSet& batch_set) {
+
+    int mi1 {monomer.get_index()};
+    eneT total_ene {0};
+    for (Monomer& mono2:
+         m_config.get_monomer_neighbours(monomer, CoorSet::current)) {
+        if (mono2.get_index() < mi1) {
+            continue;
+        }
+        total_ene += calc_monomer_pair_energy(
+                monomer,
+                CoorSet::current,
+                mono2,
+                CoorSet::current,
+                batch_set);
+    }
+
+    return total_ene;
+}
+
+void Energy::fill_pair_energies() {
+    int num_monomers {m_config.get_num_monomers()};
+    m_pair_enes.assign(num_monomers, {});
+    m_trial_pair_enes.assign(num_monomers, {});
+    m_trial_pair_enes_commit.assign(num_monomers, -1);
+    m_recalculated.assign(num_monomers, false);
+
+    // Rows are calculated in parallel and then cached in order
+    m_config.update_neighbour_lists();
+    monomerArrayT monomers {m_config.get_monomers()};
+    vector<vector<pair<int, eneT>>> upper_pair_enes(num_monomers);
+    std::exception_ptr error {};
+#pragma omp parallel for num_threads(m_num_threads) schedule(dynamic, 16)
+    for (int i = 0; i < num_monomers; i++) {
+        Monomer& monomer {monomers[i].get()};
+        try {
+            calc_upper_pair_energies(
+                    monomer,
+                    get_thread_batch_set(),
+                    upper_pair_enes[monomer.get_index()]);
+        }
+        catch (...) {
+#pragma omp critical
+            error = std::current_exception();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    for (int mi1 {0}; mi1 != num_monomers; mi1++) {
+        for (auto& p_ene: upper_pair_enes[mi1]) {
+            set_pair_energy(mi1, p_ene.first, p_ene.second);
+        }
+    }
+}
+
+void Energy::set_pair_energy(int monomer_i1, int monomer_i2, eneT ene) {
+    if (ene == 0) {
+        return;
+    }
+    m_pair_enes[monomer_i1][monomer_i2] = ene;
+    m_pair_enes[monomer_i2][monomer_i1] = ene;
+}
+
+eneT Energy::clear_pair_energies(int monomer_i) {
+    unordered_map<int, eneT>& pair_enes {m_pair_enes[monomer_i]};
+    eneT cleared_ene {0};
+    for (auto& p_ene: pair_enes) {
+        cleared_ene += p_ene.second;
+        m_pair_enes[p_ene.first].erase(monomer_i);
+    }
+    pair_enes.clear();
+
+    return cleared_ene;
+}
+
+eneT Energy::calc_pair_energies(Monomer& monomer) {
+    int mi1 {monomer.get_index()};
+    eneT total_ene {0};
+    for (Monomer& mono2:
+         m_config.get_monomer_neighbours(monomer, CoorSet::current)) {
+        int mi2 {mono2.get_index()};
+        if (m_recalculated[mi2]) {
+            continue;
+        }
+        eneT ene {calc_monomer_pair_energy(
+                monomer, CoorSet::current, mono2, CoorSet::current)};
+        set_pair_energy(mi1, mi2, ene);
+        total_ene += ene;
+    }
+
+    return total_ene;
 }
 
 } // namespace energy
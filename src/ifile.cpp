@@ -1,6 +1,8 @@
 // ifile.cpp
 
+#include <cstring>
 #include <fstream>
+#include <iostream>
 #include <string>
 
 #include "Json/json.hpp"
@@ -174,4 +176,127 @@ void InputEnergyFile::parse_json() {
         }
     }
 }
+
+std::uint64_t calc_binary_frame_bytes(int num_monomers, int num_particles) {
+    std::uint64_t conformer_bytes {
+            (num_monomers * sizeof(std::int32_t) + 7) / 8 * 8};
+
+    return sizeof(std::uint64_t) + conformer_bytes +
+           12 * sizeof(double) * num_particles;
+}
+
+BinaryTrajectoryInputFile::BinaryTrajectoryInputFile(string filename):
+        m_file {filename, std::ios::binary} {
+
+    if (not m_file) {
+        cout << "Could not open trajectory file " << filename << "\n";
+        throw InputError {};
+    }
+    read(&m_header, sizeof(m_header));
+    if (std::memcmp(
+                m_header.magic,
+                binary_trajectory_magic,
+                sizeof(binary_trajectory_magic)) != 0) {
+        cout << filename << " is not a binary trajectory file\n";
+        throw InputError {};
+    }
+    if (m_header.version != binary_trajectory_version) {
+        cout << "Unsupported binary trajectory version " << m_header.version
+             << "\n";
+        throw InputError {};
+    }
+    m_particle_types.resize(m_header.num_particles);
+    m_particle_monomers.resize(m_header.num_particles);
+    read(m_particle_types.data(),
+         m_header.num_particles * sizeof(std::int32_t));
+    read(m_particle_monomers.data(),
+         m_header.num_particles * sizeof(std::int32_t));
+    if (m_header.index_offset) {
+        read_index();
+    }
+    else {
+        recover_index();
+    }
+}
+
+int BinaryTrajectoryInputFile::get_num_frames() { return m_offsets.size(); }
+
+int BinaryTrajectoryInputFile::get_num_monomers() {
+    return m_header.num_monomers;
+}
+
+int BinaryTrajectoryInputFile::get_num_particles() {
+    return m_header.num_particles;
+}
+
+distT BinaryTrajectoryInputFile::get_box_len() { return m_header.box_len; }
+
+distT BinaryTrajectoryInputFile::get_radius() { return m_header.radius; }
+
+vector<std::int32_t> BinaryTrajectoryInputFile::get_particle_types() {
+    return m_particle_types;
+}
+
+vector<std::int32_t> BinaryTrajectoryInputFile::get_particle_monomers() {
+    return m_particle_monomers;
+}
+
+stepT BinaryTrajectoryInputFile::get_step(int frame_i) {
+    return m_steps.at(frame_i);
+}
+
+void BinaryTrajectoryInputFile::read_frame(
+        int frame_i,
+        TrajectoryFrame& frame) {
+
+    int num_monomers {get_num_monomers()};
+    int num_particles {get_num_particles()};
+    std::uint64_t conformer_bytes {m_header.frame_bytes -
+                                   sizeof(std::uint64_t) -
+                                   12 * sizeof(double) * num_particles};
+    frame.conformers.resize(conformer_bytes / sizeof(std::int32_t));
+    frame.positions.resize(3 * num_particles);
+    frame.orientations.resize(9 * num_particles);
+    m_file.seekg(m_offsets.at(frame_i));
+    read(&frame.step, sizeof(frame.step));
+    read(frame.conformers.data(), conformer_bytes);
+    read(frame.positions.data(), frame.positions.size() * sizeof(double));
+    read(frame.orientations.data(),
+         frame.orientations.size() * sizeof(double));
+
+    // Drop the padding
+    frame.conformers.resize(num_monomers);
+}
+
+void BinaryTrajectoryInputFile::read_index() {
+    m_steps.resize(m_header.num_frames);
+    m_offsets.resize(m_header.num_frames);
+    m_file.seekg(m_header.index_offset);
+    for (std::uint64_t i {0}; i != m_header.num_frames; i++) {
+        read(&m_steps[i], sizeof(stepT));
+        read(&m_offsets[i], sizeof(std::uint64_t));
+    }
+}
+
+void BinaryTrajectoryInputFile::recover_index() {
+    std::uint64_t offset {static_cast<std::uint64_t>(m_file.tellg())};
+    m_file.seekg(0, std::ios::end);
+    std::uint64_t file_bytes {static_cast<std::uint64_t>(m_file.tellg())};
+    for (; offset + m_header.frame_bytes <= file_bytes;
+         offset += m_header.frame_bytes) {
+        stepT step;
+        m_file.seekg(offset);
+        read(&step, sizeof(step));
+        m_steps.push_back(step);
+        m_offsets.push_back(offset);
+    }
+}
+
+void BinaryTrajectoryInputFile::read(void* data, std::uint64_t bytes) {
+    m_file.read(static_cast<char*>(data), bytes);
+    if (not m_file) {
+        cout << "Binary trajectory file is truncated\n";
+        throw InputError {};
+    }
+}
 } // namespace ifile
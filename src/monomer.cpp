@@ -16,13 +16,18 @@ using shared_types::CoorSet;
 using shared_types::distT;
 using std::cout;
 
-Monomer::Monomer(MonomerData m_data, CuboidPBC& pbc_space):
+Monomer::Monomer(
+        MonomerData m_data,
+        CuboidPBC& pbc_space,
+        CellList& cells,
+        ParticleStore& store):
         m_index {m_data.index},
         m_trial_conformer {m_data.conformer},
         m_conformer {m_data.conformer},
-        m_space {pbc_space} {
+        m_space {pbc_space},
+        m_cells {cells} {
 
-    create_particles(m_data.particles, pbc_space);
+    create_particles(m_data.particles, pbc_space, store);
 
     // Create reference array
     for (auto& p: m_particles) {
@@ -118,11 +123,13 @@ void Monomer::trial_to_current() {
         Particle& particle {m_particle_refs[i].get()};
         particle.trial_to_current();
     }
+    m_cells.update(m_index, get_center(CoorSet::current));
 }
 
 void Monomer::create_particles(
         vector<ParticleData> p_datas,
-        CuboidPBC& pbc_space) {
+        CuboidPBC& pbc_space,
+        ParticleStore& store) {
 
     for (auto p_data: p_datas) {
         int type {p_data.type};
@@ -130,25 +137,25 @@ void Monomer::create_particles(
         Orientation ore {};
         if (p_data.form == "SimpleParticle") {
             part = new Particle {
-                    p_data.index, type, p_data.pos, ore, pbc_space};
+                    p_data.index, type, p_data.pos, ore, pbc_space, store};
         }
         else if (p_data.form == "PatchyParticle") {
             ore.patch_norm = p_data.patch_norm;
             part = new PatchyParticle {
-                    p_data.index, type, p_data.pos, ore, pbc_space};
+                    p_data.index, type, p_data.pos, ore, pbc_space, store};
         }
         else if (p_data.form == "OrientedPatchyParticle") {
             ore.patch_norm = p_data.patch_norm;
             ore.patch_orient = p_data.patch_orient;
             part = new OrientedPatchyParticle {
-                    p_data.index, type, p_data.pos, ore, pbc_space};
+                    p_data.index, type, p_data.pos, ore, pbc_space, store};
         }
         else if (p_data.form == "DoubleOrientedPatchyParticle") {
             ore.patch_norm = p_data.patch_norm;
             ore.patch_orient = p_data.patch_orient;
             ore.patch_orient2 = p_data.patch_orient2;
             part = new DoubleOrientedPatchyParticle {
-                    p_data.index, type, p_data.pos, ore, pbc_space};
+                    p_data.index, type, p_data.pos, ore, pbc_space, store};
         }
         else {
             cout << "Particle type unknown\n";
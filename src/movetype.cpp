@@ -2,8 +2,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <exception>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "Eigen/Geometry"
 
 #include "BlobCrystallinOligomer/movetype.h"
@@ -15,7 +20,6 @@ using shared_types::CoorSet;
 using shared_types::inf;
 using std::cout;
 using std::exp;
-using std::find;
 using std::fmax;
 using std::fmin;
 
@@ -59,6 +63,14 @@ void TranslationMovemap::apply_movemap(Monomer& monomer) {
     monomer.translate(m_disp_v);
 }
 
+void TranslationMovemap::scale_amplitudes(double factor) {
+    m_max_disp_tc *= factor;
+}
+
+void TranslationMovemap::write_amplitudes(ostream& out) {
+    out << "Maximum translation: " << m_max_disp_tc << "\n";
+}
+
 RotationMovemap::RotationMovemap(
         distT max_disp_rc,
         distT max_disp_a,
@@ -81,6 +93,16 @@ void RotationMovemap::apply_movemap(Monomer& monomer) {
     monomer.rotate(m_rot_c, m_rot_mat);
 }
 
+void RotationMovemap::scale_amplitudes(double factor) {
+    m_max_disp_rc *= factor;
+    m_max_disp_a = fmin(m_max_disp_a * factor, 2 * M_PI);
+}
+
+void RotationMovemap::write_amplitudes(ostream& out) {
+    out << "Maximum rotation center displacement: " << m_max_disp_rc << "\n";
+    out << "Maximum rotation angle: " << m_max_disp_a << "\n";
+}
+
 NTDFlipMovemap::NTDFlipMovemap(Config& config, RandomGens& random_num):
         Movemap {random_num}, m_config {config} {
 
@@ -92,18 +114,18 @@ void NTDFlipMovemap::generate_movemap(Monomer& monomer) {
     vecT plane_normal;
     auto r = m_random_num.uniform_real();
     if (r < 0.25) {
-        auto p = particles[0].get();
+        auto& p = particles[0].get();
         plane_normal = p.get_ore(CoorSet::current).patch_orient;
         m_point_in_plane = p.get_pos(CoorSet::current);
     }
     else if (r < 0.5) {
-        auto p = particles[2].get();
+        auto& p = particles[2].get();
         plane_normal = p.get_ore(CoorSet::current).patch_norm;
         m_point_in_plane = p.get_pos(CoorSet::current);
     }
     else if (r < 0.75) {
-        auto p1 = particles[0].get();
-        auto p2 = particles[1].get();
+        auto& p1 = particles[0].get();
+        auto& p2 = particles[1].get();
         auto axis = m_config.calc_interparticle_vector(
                 p1, CoorSet::current, p2, CoorSet::current);
         axis.normalize();
@@ -113,8 +135,8 @@ void NTDFlipMovemap::generate_movemap(Monomer& monomer) {
         m_point_in_plane = p1.get_pos(CoorSet::current);
     }
     else {
-        auto p1 = particles[2].get();
-        auto p2 = particles[3].get();
+        auto& p1 = particles[2].get();
+        auto& p2 = particles[3].get();
         auto axis = m_config.calc_interparticle_vector(
                 p1, CoorSet::current, p2, CoorSet::current);
         axis.normalize();
@@ -132,6 +154,28 @@ void NTDFlipMovemap::apply_movemap(Monomer& monomer) {
     monomer.flip_conformation();
 }
 
+unique_ptr<Movemap> create_movemap(
+        string movemap_type,
+        Config& conf,
+        InputParams& params,
+        RandomGens& random_num) {
+
+    unique_ptr<Movemap> movemap {};
+    if (movemap_type == "translation") {
+        movemap = std::make_unique<TranslationMovemap>(
+                params.m_max_disp_tc, random_num);
+    }
+    else if (movemap_type == "rotation") {
+        movemap = std::make_unique<RotationMovemap>(
+                params.m_max_disp_rc, params.m_max_disp_a, random_num);
+    }
+    else if (movemap_type == "ntdflip") {
+        movemap = std::make_unique<NTDFlipMovemap>(conf, random_num);
+    }
+
+    return movemap;
+}
+
 MCMovetype::MCMovetype(
         Config& conf,
         Energy& ene,
@@ -146,6 +190,48 @@ MCMovetype::MCMovetype(
 
 string MCMovetype::get_label() { return m_label; }
 
+eneT MCMovetype::get_de() { return m_de; }
+
+distT MCMovetype::get_disp2() { return m_disp2; }
+
+void MCMovetype::set_sweep(bool sweep) {
+    m_sweep = sweep;
+    m_sweep_order.clear();
+    if (m_sweep) {
+        m_sweep_order = m_config.calc_spatial_order();
+    }
+    m_sweep_pos = 0;
+}
+
+Monomer& MCMovetype::select_monomer() {
+    if (not m_sweep) {
+        return m_config.get_random_monomer();
+    }
+    if (m_sweep_pos == m_sweep_order.size()) {
+        m_sweep_pos = 0;
+    }
+
+    return m_config.get_monomer(m_sweep_order[m_sweep_pos++]);
+}
+
+distT MCMovetype::calc_disp2(Monomer& monomer) {
+    CoorSet current {CoorSet::current};
+    CoorSet trial {CoorSet::trial};
+    distT disp {m_config.calc_dist(monomer, current, monomer, trial)};
+
+    return disp * disp;
+}
+
+void MCMovetype::set_beta(eneT beta) { m_beta = beta; }
+
+void MCMovetype::scale_amplitudes(double factor) {
+    m_movemap->scale_amplitudes(factor);
+}
+
+void MCMovetype::write_amplitudes(ostream& out) {
+    m_movemap->write_amplitudes(out);
+}
+
 MetMCMovetype::MetMCMovetype(
         Config& conf,
         Energy& ene,
@@ -155,27 +241,20 @@ MetMCMovetype::MetMCMovetype(
         string movemap_type):
         MCMovetype {conf, ene, random_num, params, label} {
 
-    if (movemap_type == "translation") {
-        m_movemap = std::make_unique<TranslationMovemap>(
-                params.m_max_disp_tc, random_num);
-    }
-    else if (movemap_type == "rotation") {
-        m_movemap = std::make_unique<RotationMovemap>(
-                params.m_max_disp_rc, params.m_max_disp_a, random_num);
-    }
-    else if (movemap_type == "ntdflip") {
-        m_movemap = std::make_unique<NTDFlipMovemap>(conf, random_num);
-    }
+    m_movemap = create_movemap(movemap_type, conf, params, random_num);
 }
 
 bool MetMCMovetype::move() {
-    Monomer& m {m_config.get_random_monomer()};
+    Monomer& m {select_monomer()};
     m_movemap->generate_movemap(m);
     m_movemap->apply_movemap(m);
     eneT de {m_energy.calc_monomer_diff(m)};
     bool accepted {accept_move(de)};
+    m_de = 0;
+    m_disp2 = 0;
     if (accepted) {
-        m.trial_to_current();
+        m_disp2 = calc_disp2(m);
+        m_de = m_energy.trial_to_current(m);
     }
     else {
         m.current_to_trial();
@@ -185,6 +264,10 @@ bool MetMCMovetype::move() {
 }
 
 bool MetMCMovetype::accept_move(eneT de) {
+    return accept_move(de, m_random_num);
+}
+
+bool MetMCMovetype::accept_move(eneT de, RandomGens& random_num) {
     bool accept;
     if (de == inf) {
         accept = false;
@@ -195,7 +278,7 @@ bool MetMCMovetype::accept_move(eneT de) {
             accept = true;
         }
         else {
-            if (paccept > m_random_num.uniform_real()) {
+            if (paccept > random_num.uniform_real()) {
                 accept = true;
             }
             else {
@@ -207,82 +290,333 @@ bool MetMCMovetype::accept_move(eneT de) {
     return accept;
 }
 
-VMMCMovetype::VMMCMovetype(
+ParallelMetMCMovetype::ParallelMetMCMovetype(
         Config& conf,
         Energy& ene,
         RandomGens& random_num,
         InputParams params,
         string label,
         string movemap_type):
-        MCMovetype {conf, ene, random_num, params, label} {
+        MetMCMovetype {conf, ene, random_num, params, label, movemap_type},
+        m_num_threads {std::max(params.m_num_threads, 1)} {
 
-    if (movemap_type == "translation") {
-        m_movemap = std::make_unique<TranslationMovemap>(
-                params.m_max_disp_tc, random_num);
+    for (int i {0}; i != m_num_threads; i++) {
+        m_thread_random_nums.push_back(std::make_unique<RandomGens>());
+        m_thread_movemaps.push_back(create_movemap(
+                movemap_type, conf, params, *m_thread_random_nums.back()));
     }
-    else if (movemap_type == "rotation") {
-        m_movemap = std::make_unique<RotationMovemap>(
-                params.m_max_disp_rc, params.m_max_disp_a, random_num);
+}
+
+void ParallelMetMCMovetype::scale_amplitudes(double factor) {
+    MetMCMovetype::scale_amplitudes(factor);
+    for (auto& movemap: m_thread_movemaps) {
+        movemap->scale_amplitudes(factor);
     }
 }
 
+int ParallelMetMCMovetype::get_thread_num() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+CheckerboardMetMCMovetype::CheckerboardMetMCMovetype(
+        Config& conf,
+        Energy& ene,
+        RandomGens& random_num,
+        InputParams params,
+        string label,
+        string movemap_type):
+        ParallelMetMCMovetype {
+                conf, ene, random_num, params, label, movemap_type},
+        m_cells_per_side {conf.get_cells_per_side()} {
+
+    // Domains must be at least two cells wide and alternate in colour
+    int n {m_cells_per_side};
+    m_domains_per_side = 2 * (n / 4);
+    if (m_domains_per_side == 0) {
+        m_domains_per_side = 1;
+    }
+    int d {m_domains_per_side};
+    for (int i {0}; i != n; i++) {
+        m_cell_domains.push_back(i * d / n);
+    }
+    m_colour_domains.assign(8, {});
+    for (int x {0}; x != d; x++) {
+        for (int y {0}; y != d; y++) {
+            for (int z {0}; z != d; z++) {
+                int colour {(x % 2) * 4 + (y % 2) * 2 + z % 2};
+                m_colour_domains[colour].push_back((x * d + y) * d + z);
+            }
+        }
+    }
+    m_domain_monomers.assign(d * d * d, {});
+}
+
+bool CheckerboardMetMCMovetype::move() {
+    for (int i {0}; i != 3; i++) {
+        m_offset[i] = m_random_num.uniform_int(0, m_cells_per_side - 1);
+    }
+    vector<int> colours {0, 1, 2, 3, 4, 5, 6, 7};
+    for (int i {7}; i != 0; i--) {
+        std::swap(colours[i], colours[m_random_num.uniform_int(0, i)]);
+    }
+    for (auto& monomers: m_domain_monomers) {
+        monomers.clear();
+    }
+    for (Monomer& monomer: m_config.get_monomers()) {
+        int domain_i {calc_domain(monomer.get_center(CoorSet::current))};
+        m_domain_monomers[domain_i].push_back(monomer.get_index());
+    }
+
+    m_config.suspend_neighbour_lists();
+    m_de = 0;
+    m_disp2 = 0;
+    int accepts {0};
+    std::exception_ptr error {};
+    for (int colour: colours) {
+        vector<int>& domains {m_colour_domains[colour]};
+        int num_domains {static_cast<int>(domains.size())};
+        eneT de {0};
+        distT disp2 {0};
+#pragma omp parallel for num_threads(m_num_threads) schedule(dynamic, 1) \
+        reduction(+ : de, accepts, disp2)
+        for (int i = 0; i < num_domains; i++) {
+            try {
+                de += sweep_domain(domains[i], accepts, disp2);
+            }
+            catch (...) {
+#pragma omp critical
+                error = std::current_exception();
+            }
+        }
+        m_de += de;
+        m_disp2 += disp2;
+        if (error) {
+            break;
+        }
+    }
+    m_config.resume_neighbour_lists();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    return accepts != 0;
+}
+
+int CheckerboardMetMCMovetype::calc_domain(vecT pos) {
+    int n {m_cells_per_side};
+    int d {m_domains_per_side};
+    array<int, 3> cell {m_config.calc_cell_coors(pos)};
+    int domain_i {0};
+    for (int i {0}; i != 3; i++) {
+        int shifted_cell {(cell[i] - m_offset[i] + n) % n};
+        domain_i = domain_i * d + m_cell_domains[shifted_cell];
+    }
+
+    return domain_i;
+}
+
+eneT CheckerboardMetMCMovetype::sweep_domain(
+        int domain_i,
+        int& accepts,
+        distT& disp2) {
+
+    int thread_i {get_thread_num()};
+    RandomGens& random_num {*m_thread_random_nums[thread_i]};
+    Movemap& movemap {*m_thread_movemaps[thread_i]};
+    vector<int>& monomers {m_domain_monomers[domain_i]};
+    int num_monomers {static_cast<int>(monomers.size())};
+    eneT de {0};
+    for (int i {0}; i != num_monomers; i++) {
+        int monomer_i {monomers[random_num.uniform_int(0, num_monomers - 1)]};
+        Monomer& monomer {m_config.get_monomer(monomer_i)};
+        movemap.generate_movemap(monomer);
+        movemap.apply_movemap(monomer);
+        if (calc_domain(monomer.get_center(CoorSet::trial)) != domain_i) {
+            monomer.current_to_trial();
+            continue;
+        }
+        if (accept_move(m_energy.calc_monomer_diff(monomer), random_num)) {
+            disp2 += calc_disp2(monomer);
+            de += m_energy.trial_to_current(monomer);
+            accepts++;
+        }
+        else {
+            monomer.current_to_trial();
+        }
+    }
+
+    return de;
+}
+
+SpeculativeMetMCMovetype::SpeculativeMetMCMovetype(
+        Config& conf,
+        Energy& ene,
+        RandomGens& random_num,
+        InputParams params,
+        string label,
+        string movemap_type):
+        ParallelMetMCMovetype {
+                conf, ene, random_num, params, label, movemap_type},
+        m_batch_size {std::min(
+                params.m_speculative_batch, conf.get_num_monomers())} {
+
+    for (int i {0}; i != conf.get_num_monomers(); i++) {
+        m_monomer_order.push_back(i);
+    }
+    m_centers.resize(m_batch_size);
+    m_trial_centers.resize(m_batch_size);
+    m_des.resize(m_batch_size);
+}
+
+bool SpeculativeMetMCMovetype::move() {
+
+    // Draw distinct monomers
+    int num_monomers {static_cast<int>(m_monomer_order.size())};
+    for (int i {0}; i != m_batch_size; i++) {
+        int j {m_random_num.uniform_int(i, num_monomers - 1)};
+        std::swap(m_monomer_order[i], m_monomer_order[j]);
+    }
+
+    // Lists must not be rebuilt while evaluating
+    m_config.update_neighbour_lists();
+    std::exception_ptr error {};
+#pragma omp parallel for num_threads(m_num_threads) schedule(dynamic, 1)
+    for (int i = 0; i < m_batch_size; i++) {
+        int thread_i {get_thread_num()};
+        Movemap& movemap {*m_thread_movemaps[thread_i]};
+        Monomer& monomer {m_config.get_monomer(m_monomer_order[i])};
+        try {
+            m_centers[i] = monomer.get_center(CoorSet::current);
+            movemap.generate_movemap(monomer);
+            movemap.apply_movemap(monomer);
+            m_trial_centers[i] = monomer.get_center(CoorSet::trial);
+            m_des[i] = m_energy.calc_monomer_diff(monomer);
+        }
+        catch (...) {
+#pragma omp critical
+            error = std::current_exception();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    // Commit in order
+    m_de = 0;
+    m_disp2 = 0;
+    m_committed.clear();
+    for (int i {0}; i != m_batch_size; i++) {
+        Monomer& monomer {m_config.get_monomer(m_monomer_order[i])};
+        eneT de {m_des[i]};
+        if (conflicts(i)) {
+            de = m_energy.calc_monomer_diff(monomer);
+        }
+        else {
+            m_energy.keep_trial_pair_energies(monomer);
+        }
+        if (accept_move(de)) {
+            m_disp2 += calc_disp2(monomer);
+            m_de += m_energy.trial_to_current(monomer);
+            m_committed.push_back(i);
+        }
+        else {
+            monomer.current_to_trial();
+        }
+    }
+
+    return not m_committed.empty();
+}
+
+bool SpeculativeMetMCMovetype::conflicts(int proposal_i) {
+    distT interaction_len {m_config.get_interaction_len()};
+    vecT& center {m_centers[proposal_i]};
+    vecT& trial_center {m_trial_centers[proposal_i]};
+    for (int i: m_committed) {
+        for (vecT* pos: {&m_centers[i], &m_trial_centers[i]}) {
+            if (m_config.calc_dist(center, *pos) < interaction_len or
+                m_config.calc_dist(trial_center, *pos) < interaction_len) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+VMMCMovetype::VMMCMovetype(
+        Config& conf,
+        Energy& ene,
+        RandomGens& random_num,
+        InputParams params,
+        string label,
+        string movemap_type):
+        MCMovetype {conf, ene, random_num, params, label},
+        m_num_threads {std::max(params.m_num_threads, 1)} {
+
+    m_movemap = create_movemap(movemap_type, conf, params, random_num);
+    int num_monomers {m_config.get_num_monomers()};
+    m_cluster.reserve(num_monomers);
+    m_transformed_mis.reserve(num_monomers);
+    m_pair_mis.reserve(num_monomers);
+    m_pair_enes.reserve(num_monomers);
+    m_candidate_mis.reserve(num_monomers);
+    m_candidate_enes.reserve(num_monomers);
+    m_cluster_stamps.assign(num_monomers, 0);
+    m_transformed_stamps.assign(num_monomers, 0);
+    m_proposed_stamps.assign(num_monomers, 0);
+    m_frustrated_stamps.assign(num_monomers, 0);
+    m_frustrated_counts.assign(num_monomers, 0);
+}
+
 bool VMMCMovetype::move() {
-    Monomer& monomer_seed {m_config.get_random_monomer()};
-    m_cluster.emplace_back(monomer_seed);
-    m_interacting_mis.insert(monomer_seed.get_index());
+    m_move_stamp++;
+    Monomer& monomer_seed {select_monomer()};
+    add_to_cluster(monomer_seed);
     m_movemap->generate_movemap(monomer_seed);
-    m_movemap->apply_movemap(monomer_seed);
+    transform(monomer_seed);
     add_interacting_pairs(monomer_seed);
     while (m_pair_mis.size() != 0) {
         pair<int, int> cur_pair {pop_random_pair()};
         Monomer& monomer1 {m_config.get_monomer(cur_pair.first)};
         Monomer& monomer2 {m_config.get_monomer(cur_pair.second)};
-        bool mono_in_cluster {false};
-        for (auto mono_cluster: m_cluster) {
-            if (monomer2.get_index() == mono_cluster.get().get_index()) {
-                mono_in_cluster = true;
-                break;
-            }
-        }
-        if (mono_in_cluster) {
+        int mono_i2 {cur_pair.second};
+        if (in_cluster(mono_i2)) {
             continue;
         }
-        eneT ene_1 {m_energy.calc_monomer_pair_energy(
-                monomer1, CoorSet::current, monomer2, CoorSet::current)};
-        eneT ene_2 {m_energy.calc_monomer_pair_energy(
+        eneT ene_1 {m_energy.get_pair_energy(monomer1, monomer2)};
+        eneT ene_2 {get_memo_pair_energy(
                 monomer1, CoorSet::trial, monomer2, CoorSet::current)};
         double prelink_for_p {calc_prelink_prob(ene_1, ene_2)};
         bool prelink_accepted {accept_prelink(prelink_for_p)};
         if (not prelink_accepted) {
             continue;
         }
-        eneT ene_3 {m_energy.calc_monomer_pair_energy(
+        transform(monomer2);
+        eneT ene_3 {get_memo_pair_energy(
                 monomer1, CoorSet::current, monomer2, CoorSet::trial)};
         double prelink_rev_p {calc_prelink_prob(ene_1, ene_3)};
         bool link_accepted {accept_link(prelink_for_p, prelink_rev_p)};
         if (not link_accepted) {
-            m_frustrated_links++;
-            m_frustrated_mis.push_back(monomer2.get_index());
+            frustrate_link(mono_i2);
             continue;
         }
-        auto frustrated_mi {
-                find(m_frustrated_mis.begin(),
-                     m_frustrated_mis.end(),
-                     monomer2.get_index())};
-        if (frustrated_mi != m_frustrated_mis.end()) {
-            m_frustrated_links--;
-            m_frustrated_mis.erase(frustrated_mi);
-        }
-        m_cluster.emplace_back(monomer2);
+        add_to_cluster(monomer2);
         add_interacting_pairs(monomer2);
     }
     bool accepted {accept_move()};
+    m_de = 0;
+    m_disp2 = 0;
     if (accepted) {
-        for (Monomer& mono: m_cluster) {
-            mono.trial_to_current();
+        for (Monomer& monomer: m_cluster) {
+            m_disp2 += calc_disp2(monomer);
         }
+        m_de = m_energy.trial_to_current(m_cluster);
     }
-    for (auto i: m_interacting_mis) {
+    for (auto i: m_transformed_mis) {
         Monomer& mono {m_config.get_monomer(i)};
         mono.current_to_trial();
     }
@@ -293,52 +627,133 @@ bool VMMCMovetype::move() {
 
 void VMMCMovetype::add_interacting_pairs(Monomer& monomer1) {
 
-    // Get all monomers that are interacting before and after movemap
-    monomerArrayT monomers {
-            m_energy.get_interacting_monomers(monomer1, CoorSet::current)};
-    monomerArrayT trial_monomers {
-            m_energy.get_interacting_monomers(monomer1, CoorSet::trial)};
-    monomers.insert(
-            monomers.end(), trial_monomers.begin(), trial_monomers.end());
-
-    for (Monomer& mono_any: monomers) {
-
-        // The second monomer should not already be in the cluster
-        int mono_i2 {mono_any.get_index()};
-        bool mono_in_cluster {false};
-        for (auto mono_cluster: m_cluster) {
-            if (mono_i2 == mono_cluster.get().get_index()) {
-                mono_in_cluster = true;
-                break;
+    // Candidates are neighbours before and after the movemap that are not
+    // in the cluster. Each cluster monomer is only added once, so pairs
+    // proposed before have this as the first monomer and were found here
+    m_proposal_stamp++;
+    m_candidate_mis.clear();
+    for (CoorSet coorset: {CoorSet::current, CoorSet::trial}) {
+        for (Monomer& mono_any:
+             m_config.get_monomer_neighbours(monomer1, coorset)) {
+            int mono_i2 {mono_any.get_index()};
+            if (in_cluster(mono_i2) or
+                m_proposed_stamps[mono_i2] == m_proposal_stamp) {
+                continue;
             }
+            m_proposed_stamps[mono_i2] = m_proposal_stamp;
+            m_candidate_mis.push_back(mono_i2);
         }
-        if (mono_in_cluster) {
-            continue;
+    }
+
+    // Forward link energies
+    int num_candidates {static_cast<int>(m_candidate_mis.size())};
+    m_candidate_enes.resize(num_candidates);
+    std::exception_ptr error {};
+#pragma omp parallel for num_threads(m_num_threads) schedule(dynamic, 8) \
+        if (num_candidates > 1)
+    for (int i = 0; i < num_candidates; i++) {
+        Monomer& monomer2 {m_config.get_monomer(m_candidate_mis[i])};
+        try {
+            eneT ene {0};
+            if (m_energy.monomers_in_range(
+                        monomer1, CoorSet::trial, monomer2, CoorSet::current)) {
+                ene = m_energy.calc_monomer_pair_energy(
+                        monomer1, CoorSet::trial, monomer2, CoorSet::current);
+            }
+            m_candidate_enes[i] = ene;
         }
+        catch (...) {
+#pragma omp critical
+            error = std::current_exception();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
 
-        // The pair should not have been proposed before
-        int mono_i1 {monomer1.get_index()};
-        pair<int, int> pair_mis {mono_i1, mono_i2};
-        auto proposed {not m_proposed_pairs.insert(pair_mis).second};
-        if (proposed) {
+    // Pairs with no interaction before or after the movemap have a prelink
+    // probability of zero, so are never proposed
+    for (int i {0}; i != num_candidates; i++) {
+        Monomer& monomer2 {m_config.get_monomer(m_candidate_mis[i])};
+        eneT ene {m_candidate_enes[i]};
+        m_pair_enes.emplace(
+                memo_key(monomer1, CoorSet::trial, monomer2, CoorSet::current),
+                ene);
+        if (ene == 0 and m_energy.get_pair_energy(monomer1, monomer2) == 0) {
             continue;
         }
+        m_pair_mis.emplace_back(monomer1.get_index(), m_candidate_mis[i]);
+    }
+}
 
-        // Only apply the movemap once TODO only apply after prelink accepted
-        bool movemap_applied {not m_interacting_mis.insert(mono_i2).second};
-        if (not movemap_applied) {
-            m_movemap->apply_movemap(mono_any);
-        }
-        m_pair_mis.insert(pair_mis);
+void VMMCMovetype::add_to_cluster(Monomer& monomer) {
+    int monomer_i {monomer.get_index()};
+    m_cluster.emplace_back(monomer);
+    m_cluster_stamps[monomer_i] = m_move_stamp;
+
+    // Links to a monomer that joins the cluster are no longer frustrated
+    if (m_frustrated_stamps[monomer_i] == m_move_stamp) {
+        m_frustrated_links -= m_frustrated_counts[monomer_i];
+        m_frustrated_counts[monomer_i] = 0;
     }
 }
 
+void VMMCMovetype::frustrate_link(int monomer_i) {
+    m_frustrated_links++;
+    if (m_frustrated_stamps[monomer_i] != m_move_stamp) {
+        m_frustrated_stamps[monomer_i] = m_move_stamp;
+        m_frustrated_counts[monomer_i] = 0;
+    }
+    m_frustrated_counts[monomer_i]++;
+}
+
+bool VMMCMovetype::in_cluster(int monomer_i) {
+    return m_cluster_stamps[monomer_i] == m_move_stamp;
+}
+
+void VMMCMovetype::transform(Monomer& monomer) {
+    int monomer_i {monomer.get_index()};
+    if (m_transformed_stamps[monomer_i] == m_move_stamp) {
+        return;
+    }
+    m_transformed_stamps[monomer_i] = m_move_stamp;
+    m_transformed_mis.push_back(monomer_i);
+    m_movemap->apply_movemap(monomer);
+}
+
+eneT VMMCMovetype::get_memo_pair_energy(
+        Monomer& monomer1,
+        CoorSet coorset1,
+        Monomer& monomer2,
+        CoorSet coorset2) {
+
+    pair<int, int> key {memo_key(monomer1, coorset1, monomer2, coorset2)};
+    auto memo_ene {m_pair_enes.find(key)};
+    if (memo_ene != m_pair_enes.end()) {
+        return memo_ene->second;
+    }
+    eneT ene {m_energy.calc_monomer_pair_energy(
+            monomer1, coorset1, monomer2, coorset2)};
+    m_pair_enes.emplace(key, ene);
+
+    return ene;
+}
+
+pair<int, int> VMMCMovetype::memo_key(
+        Monomer& monomer1,
+        CoorSet coorset1,
+        Monomer& monomer2,
+        CoorSet coorset2) {
+
+    return {2 * monomer1.get_index() + (coorset1 == CoorSet::trial),
+            2 * monomer2.get_index() + (coorset2 == CoorSet::trial)};
+}
+
 pair<int, int> VMMCMovetype::pop_random_pair() {
     int pair_i {m_random_num.uniform_int(0, m_pair_mis.size() - 1)};
-    set<pair<int, int>>::const_iterator it {m_pair_mis.begin()};
-    std::advance(it, pair_i);
-    pair<int, int> sel_pair {*it};
-    m_pair_mis.erase(it);
+    pair<int, int> sel_pair {m_pair_mis[pair_i]};
+    m_pair_mis[pair_i] = m_pair_mis.back();
+    m_pair_mis.pop_back();
 
     return sel_pair;
 }
@@ -400,9 +815,8 @@ bool VMMCMovetype::accept_move() {
 void VMMCMovetype::reset_internal() {
     m_cluster.clear();
     m_frustrated_links = 0;
-    m_frustrated_mis.clear();
-    m_proposed_pairs.clear();
-    m_interacting_mis.clear();
+    m_transformed_mis.clear();
     m_pair_mis.clear();
+    m_pair_enes.clear();
 }
 } // namespace movetype
@@ -0,0 +1,268 @@
+// mpi_simulation.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <mpi.h>
+
+#include "BlobCrystallinOligomer/mpi_simulation.h"
+
+namespace simulation {
+
+using particle::Orientation;
+using shared_types::InputError;
+using shared_types::vecT;
+using std::cout;
+using std::make_unique;
+using std::setw;
+using std::chrono::steady_clock;
+
+namespace {
+
+/** Check if a multiple of freq is in (step - num_steps, step] */
+bool multiple_passed(stepT step, stepT num_steps, stepT freq) {
+    return freq and step / freq != (step - num_steps) / freq;
+}
+} // namespace
+
+MPIPTMCSimulation::MPIPTMCSimulation(InputParams params):
+        m_temps {params.m_temps},
+        m_steps {params.m_steps},
+        m_duration {params.m_duration},
+        m_exchange_freq {params.m_exchange_freq},
+        m_energy_check_freq {params.m_energy_check_freq},
+        m_logging_freq {params.m_logging_freq},
+        m_config_output_freq {params.m_config_output_freq} {
+
+    int num_ranks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &m_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_ranks);
+    if (m_temps.size() < 2) {
+        cout << "Parallel tempering requires at least two temperatures\n";
+        throw InputError {};
+    }
+    if (not std::is_sorted(m_temps.begin(), m_temps.end())) {
+        cout << "Parallel tempering temperatures must be increasing\n";
+        throw InputError {};
+    }
+    if (m_exchange_freq == 0) {
+        cout << "Exchange frequency must be nonzero\n";
+        throw InputError {};
+    }
+    if (static_cast<size_t>(num_ranks) != m_temps.size()) {
+        cout << "Number of MPI processes must equal number of temperatures\n";
+        throw InputError {};
+    }
+
+    // The replica is checked and its configuration output from here
+    InputParams replica_params {params};
+    replica_params.m_temp = m_temps[m_rank];
+    replica_params.m_energy_check_freq = 0;
+    replica_params.m_logging_freq = 0;
+    replica_params.m_config_output_freq = 0;
+    string filebase {params.m_output_filebase};
+    m_log.open(filebase + "-replica-" + std::to_string(m_rank) + ".log");
+    m_config = make_unique<Config>(replica_params, m_random_num);
+    m_energy = make_unique<Energy>(*m_config, replica_params);
+    m_replica = make_unique<NVTMCSimulation>(
+            *m_config, *m_energy, replica_params, m_random_num, m_log);
+    m_temp_i = m_rank;
+    if (m_config_output_freq) {
+        m_traj_writer = make_unique<TrajectoryWriter>(
+                filebase + "-" + std::to_string(m_rank),
+                *m_config,
+                params.m_output_buffer_frames,
+                params.m_binary_trajectory);
+    }
+    for (size_t i {0}; i != m_temps.size(); i++) {
+        m_temp_replicas.push_back(i);
+    }
+    m_replica_enes.assign(m_temps.size(), 0);
+    m_swap_attempts.assign(m_temps.size() - 1, 0);
+    m_swap_accepts.assign(m_temps.size() - 1, 0);
+}
+
+void MPIPTMCSimulation::run() {
+    auto start = steady_clock::now();
+    stepT step {0};
+    while (step != m_steps) {
+
+        // Run to the next exchange, output or final step
+        stepT num_steps {std::min(
+                m_exchange_freq - step % m_exchange_freq, m_steps - step)};
+        if (m_config_output_freq) {
+            num_steps = std::min(
+                    num_steps,
+                    m_config_output_freq - step % m_config_output_freq);
+        }
+        m_replica->run_steps(step + 1, num_steps);
+        step += num_steps;
+
+        // Check energy
+        if (multiple_passed(step, num_steps, m_energy_check_freq)) {
+            m_replica->check_energy(step);
+        }
+
+        // Output configurations before they may change temperature
+        if (m_config_output_freq and step % m_config_output_freq == 0) {
+            write_frames(step);
+        }
+
+        // Exchange and log
+        if (step % m_exchange_freq == 0) {
+            attempt_exchanges();
+            if (m_rank == 0 and
+                multiple_passed(step, m_exchange_freq, m_logging_freq)) {
+                log_exchange(step);
+            }
+        }
+
+        // Check if maximum allowed time reached on rank 0
+        std::chrono::duration<double> dt {(steady_clock::now() - start)};
+        int time_up {dt.count() > m_duration};
+        MPI_Bcast(&time_up, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (time_up) {
+            if (m_rank == 0) {
+                cout << "Maximum time allowed reached\n";
+            }
+            break;
+        }
+    }
+    log_summary();
+}
+
+void MPIPTMCSimulation::attempt_exchanges() {
+    eneT ene {m_replica->get_energy()};
+    MPI_Gather(
+            &ene,
+            1,
+            MPI_DOUBLE,
+            m_replica_enes.data(),
+            1,
+            MPI_DOUBLE,
+            0,
+            MPI_COMM_WORLD);
+    if (m_rank == 0) {
+        for (size_t i = m_exchanges % 2; i + 1 < m_temps.size(); i += 2) {
+            int replica1 {m_temp_replicas[i]};
+            int replica2 {m_temp_replicas[i + 1]};
+            eneT dbeta {1 / m_temps[i] - 1 / m_temps[i + 1]};
+            eneT dene {m_replica_enes[replica1] - m_replica_enes[replica2]};
+            double paccept {fmin(1, exp(dbeta * dene))};
+            m_swap_attempts[i]++;
+            if (m_exchange_random_num.uniform_real() < paccept) {
+                m_swap_accepts[i]++;
+                m_temp_replicas[i] = replica2;
+                m_temp_replicas[i + 1] = replica1;
+            }
+        }
+    }
+    m_exchanges++;
+
+    // Every rank takes the new temperature of its replica
+    MPI_Bcast(
+            m_temp_replicas.data(),
+            m_temp_replicas.size(),
+            MPI_INT,
+            0,
+            MPI_COMM_WORLD);
+    for (size_t i {0}; i != m_temp_replicas.size(); i++) {
+        if (m_temp_replicas[i] == m_rank and static_cast<int>(i) != m_temp_i) {
+            m_temp_i = i;
+            m_replica->set_temp(m_temps[m_temp_i]);
+        }
+    }
+}
+
+void MPIPTMCSimulation::write_frames(stepT step) {
+    m_frame.snapshot(*m_config, step);
+    int num_monomers {static_cast<int>(m_frame.conformers.size())};
+    int num_particles {static_cast<int>(m_frame.positions.size())};
+    m_temp_frame.step = step;
+    m_temp_frame.conformers.resize(num_monomers);
+    m_temp_frame.positions.resize(num_particles);
+    m_temp_frame.orientations.resize(num_particles);
+
+    // Coordinates are sent as raw bytes as all ranks share the same layout
+    int source {m_temp_replicas[m_rank]};
+    MPI_Sendrecv(
+            m_frame.positions.data(),
+            num_particles * sizeof(vecT),
+            MPI_BYTE,
+            m_temp_i,
+            0,
+            m_temp_frame.positions.data(),
+            num_particles * sizeof(vecT),
+            MPI_BYTE,
+            source,
+            0,
+            MPI_COMM_WORLD,
+            MPI_STATUS_IGNORE);
+    MPI_Sendrecv(
+            m_frame.orientations.data(),
+            num_particles * sizeof(Orientation),
+            MPI_BYTE,
+            m_temp_i,
+            1,
+            m_temp_frame.orientations.data(),
+            num_particles * sizeof(Orientation),
+            MPI_BYTE,
+            source,
+            1,
+            MPI_COMM_WORLD,
+            MPI_STATUS_IGNORE);
+    MPI_Sendrecv(
+            m_frame.conformers.data(),
+            num_monomers,
+            MPI_INT,
+            m_temp_i,
+            2,
+            m_temp_frame.conformers.data(),
+            num_monomers,
+            MPI_INT,
+            source,
+            2,
+            MPI_COMM_WORLD,
+            MPI_STATUS_IGNORE);
+    m_traj_writer->write_frame(m_temp_frame);
+}
+
+void MPIPTMCSimulation::log_exchange(stepT step) {
+    cout << "Step: " << step << "\n";
+    cout << "Temperature" << setw(10);
+    cout << "Replica" << setw(10);
+    cout << "Energy"
+         << "\n";
+    for (size_t i {0}; i != m_temps.size(); i++) {
+        int replica_i {m_temp_replicas[i]};
+        cout << m_temps[i] << setw(10);
+        cout << replica_i << setw(10);
+        cout << m_replica_enes[replica_i] << "\n";
+    }
+    cout << "\n";
+}
+
+void MPIPTMCSimulation::log_summary() {
+    m_replica->log_summary();
+    if (m_rank != 0) {
+        return;
+    }
+    cout << "Exchange summary"
+         << "\n";
+    cout << "Temperatures" << setw(10);
+    cout << "Attempts" << setw(10);
+    cout << "Accepts" << setw(10);
+    cout << "Frequency"
+         << "\n";
+    for (size_t i {0}; i != m_swap_attempts.size(); i++) {
+        cout << m_temps[i] << "-" << m_temps[i + 1] << setw(10);
+        cout << m_swap_attempts[i] << setw(10);
+        cout << m_swap_accepts[i] << setw(10);
+        cout << static_cast<double>(m_swap_accepts[i]) / m_swap_attempts[i]
+             << "\n";
+    }
+}
+} // namespace simulation
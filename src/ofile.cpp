@@ -1,5 +1,9 @@
 // ofile.cpp
 
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
 #include "BlobCrystallinOligomer/ofile.h"
 #include "BlobCrystallinOligomer/monomer.h"
 #include "BlobCrystallinOligomer/particle.h"
@@ -14,6 +18,20 @@ using shared_types::distT;
 using std::ifstream;
 using std::string;
 
+void ConfigFrame::snapshot(Config& conf, stepT frame_step) {
+    step = frame_step;
+    conformers.clear();
+    positions.clear();
+    orientations.clear();
+    for (Monomer& mono: conf.get_monomers()) {
+        conformers.push_back(mono.get_conformer(CoorSet::current));
+        for (Particle& part: mono.get_particles()) {
+            positions.push_back(part.get_pos(CoorSet::current));
+            orientations.push_back(part.get_ore(CoorSet::current));
+        }
+    }
+}
+
 OutputFile::OutputFile() {}
 
 OutputFile::OutputFile(string filename):
@@ -31,34 +49,41 @@ VSFOutputFile::VSFOutputFile(string filename, Config& conf):
 
 void VSFOutputFile::write_structure(Config& conf) {
     // This is a bit of a hack for the radius
+    std::ostringstream structure;
     int i {0};
     for (auto m: conf.get_monomers()) {
         for (auto p: m.get().get_particles()) {
-            m_file << "atom " << i << " ";
-            m_file << "type " << p.get().get_type() << " ";
-            m_file << "resid " << m.get().get_index() << " ";
-            m_file << "radius " << conf.get_radius() << "\n";
+            structure << "atom " << i << " ";
+            structure << "type " << p.get().get_type() << " ";
+            structure << "resid " << m.get().get_index() << " ";
+            structure << "radius " << conf.get_radius() << "\n";
             i++;
         }
     }
-    m_file << "\n";
+    structure << "\n";
     distT x {conf.get_box_len()};
-    m_file << "pbc " << x << " " << x << " " << x << "\n";
-    m_file << "\n";
+    structure << "pbc " << x << " " << x << " " << x << "\n";
+    structure << "\n";
+    m_structure = structure.str();
+    write_structure();
 }
 
+void VSFOutputFile::write_structure() { m_file << m_structure; }
+
 VCFOutputFile::VCFOutputFile() {}
 
 VCFOutputFile::VCFOutputFile(string filename): OutputFile {filename} {}
 
-void VCFOutputFile::write_step(Config& conf, stepT) {
+void VCFOutputFile::write_step(Config& conf, stepT step) {
+    m_frame.snapshot(conf, step);
+    write_step(m_frame);
+}
+
+void VCFOutputFile::write_step(const ConfigFrame& frame) {
     m_file << "t"
            << "\n";
-    for (Monomer& mono: conf.get_monomers()) {
-        for (Particle& part: mono.get_particles()) {
-            auto pos {part.get_pos(CoorSet::current)};
-            m_file << pos[0] << " " << pos[1] << " " << pos[2] << "\n";
-        }
+    for (const vecT& pos: frame.positions) {
+        m_file << pos[0] << " " << pos[1] << " " << pos[2] << "\n";
     }
     m_file << "\n";
 }
@@ -69,6 +94,12 @@ void VCFOutputFile::open_write_step_close(Config& conf, stepT step) {
     m_file.close();
 }
 
+void VCFOutputFile::open_write_step_close(const ConfigFrame& frame) {
+    m_file.open(m_filename);
+    write_step(frame);
+    m_file.close();
+}
+
 VTFOutputFile::VTFOutputFile(string filename, Config& conf):
         OutputFile {filename} {
 
@@ -82,21 +113,30 @@ void VTFOutputFile::open_write_close(Config& conf, stepT step) {
     m_file.close();
 }
 
+void VTFOutputFile::open_write_close(const ConfigFrame& frame) {
+    m_file.open(m_filename);
+    write_structure();
+    write_step(frame);
+    m_file.close();
+}
+
 PatchOutputFile::PatchOutputFile(string filename): OutputFile {filename} {}
 
 void PatchOutputFile::write_step(Config& conf) {
-    for (Monomer& mono: conf.get_monomers()) {
-        for (Particle& part: mono.get_particles()) {
-            auto ore = part.get_ore(CoorSet::current);
-            for (int i {0}; i != 3; i++) {
-                m_file << ore.patch_norm[i] << " ";
-            }
-            for (int i {0}; i != 3; i++) {
-                m_file << ore.patch_orient[i] << " ";
-            }
-            for (int i {0}; i != 3; i++) {
-                m_file << ore.patch_orient2[i] << " ";
-            }
+    m_frame.snapshot(conf, 0);
+    write_step(m_frame);
+}
+
+void PatchOutputFile::write_step(const ConfigFrame& frame) {
+    for (const Orientation& ore: frame.orientations) {
+        for (int i {0}; i != 3; i++) {
+            m_file << ore.patch_norm[i] << " ";
+        }
+        for (int i {0}; i != 3; i++) {
+            m_file << ore.patch_orient[i] << " ";
+        }
+        for (int i {0}; i != 3; i++) {
+            m_file << ore.patch_orient2[i] << " ";
         }
     }
     m_file << "\n";
@@ -107,4 +147,220 @@ void PatchOutputFile::open_write_step_close(Config& conf) {
     write_step(conf);
     m_file.close();
 }
+
+void PatchOutputFile::open_write_step_close(const ConfigFrame& frame) {
+    m_file.open(m_filename);
+    write_step(frame);
+    m_file.close();
+}
+
+BinaryTrajectoryOutputFile::BinaryTrajectoryOutputFile(
+        string filename,
+        Config& conf) {
+
+    m_filename = filename;
+    m_file.open(filename, std::ios::binary);
+    std::memcpy(
+            m_header.magic,
+            ifile::binary_trajectory_magic,
+            sizeof(m_header.magic));
+    m_header.version = ifile::binary_trajectory_version;
+    m_header.num_monomers = conf.get_num_monomers();
+    m_header.num_particles = conf.get_num_particles();
+    m_header.padding = 0;
+    m_header.box_len = conf.get_box_len();
+    m_header.radius = conf.get_radius();
+    m_header.frame_bytes = ifile::calc_binary_frame_bytes(
+            conf.get_num_monomers(), conf.get_num_particles());
+    m_header.num_frames = 0;
+    m_header.index_offset = 0;
+    m_file.write(reinterpret_cast<char*>(&m_header), sizeof(m_header));
+    vector<std::int32_t> types;
+    vector<std::int32_t> monomers;
+    for (Monomer& mono: conf.get_monomers()) {
+        for (Particle& part: mono.get_particles()) {
+            types.push_back(part.get_type());
+            monomers.push_back(mono.get_index());
+        }
+    }
+    m_file.write(
+            reinterpret_cast<char*>(types.data()),
+            types.size() * sizeof(std::int32_t));
+    m_file.write(
+            reinterpret_cast<char*>(monomers.data()),
+            monomers.size() * sizeof(std::int32_t));
+    m_offset = sizeof(m_header) + 2 * types.size() * sizeof(std::int32_t);
+    m_buffer.resize(m_header.frame_bytes);
+}
+
+BinaryTrajectoryOutputFile::~BinaryTrajectoryOutputFile() { close(); }
+
+void BinaryTrajectoryOutputFile::write_step(Config& conf, stepT step) {
+    m_frame.snapshot(conf, step);
+    write_step(m_frame);
+}
+
+void BinaryTrajectoryOutputFile::write_step(const ConfigFrame& frame) {
+
+    // The frame is assembled in a buffer to write it in one call, and
+    // padding after the conformers is left zeroed
+    std::fill(m_buffer.begin(), m_buffer.end(), 0);
+    char* pos {m_buffer.data()};
+    std::uint64_t step {frame.step};
+    std::memcpy(pos, &step, sizeof(step));
+    pos += sizeof(step);
+    for (int conformer: frame.conformers) {
+        std::int32_t conformer_32 {conformer};
+        std::memcpy(pos, &conformer_32, sizeof(conformer_32));
+        pos += sizeof(conformer_32);
+    }
+    std::uint64_t coor_bytes {12 * sizeof(double) * m_header.num_particles};
+    pos = m_buffer.data() + m_header.frame_bytes - coor_bytes;
+    for (const vecT& p: frame.positions) {
+        std::memcpy(pos, p.data(), 3 * sizeof(double));
+        pos += 3 * sizeof(double);
+    }
+    for (const Orientation& ore: frame.orientations) {
+        std::memcpy(pos, ore.patch_norm.data(), 3 * sizeof(double));
+        pos += 3 * sizeof(double);
+        std::memcpy(pos, ore.patch_orient.data(), 3 * sizeof(double));
+        pos += 3 * sizeof(double);
+        std::memcpy(pos, ore.patch_orient2.data(), 3 * sizeof(double));
+        pos += 3 * sizeof(double);
+    }
+    m_file.write(m_buffer.data(), m_buffer.size());
+    m_steps.push_back(frame.step);
+    m_offsets.push_back(m_offset);
+    m_offset += m_header.frame_bytes;
+}
+
+void BinaryTrajectoryOutputFile::close() {
+    if (not m_file.is_open()) {
+        return;
+    }
+    for (size_t i {0}; i != m_steps.size(); i++) {
+        std::uint64_t step {m_steps[i]};
+        m_file.write(reinterpret_cast<char*>(&step), sizeof(step));
+        m_file.write(
+                reinterpret_cast<char*>(&m_offsets[i]),
+                sizeof(std::uint64_t));
+    }
+    m_header.num_frames = m_steps.size();
+    m_header.index_offset = m_offset;
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<char*>(&m_header), sizeof(m_header));
+    m_file.close();
+}
+
+TrajectoryWriter::TrajectoryWriter(
+        string filebase,
+        Config& conf,
+        int buffer_frames,
+        bool binary):
+        m_pipe_vtf_file {filebase + "_pipe.vtf", conf},
+        m_pipe_patch_file {filebase + "_pipe.patch"},
+        m_frames(std::max(buffer_frames, 1)) {
+
+    if (binary) {
+        m_binary_file = std::make_unique<BinaryTrajectoryOutputFile>(
+                filebase + ".btr", conf);
+    }
+    else {
+        m_vtf_file = std::make_unique<VTFOutputFile>(filebase + ".vtf", conf);
+        m_patch_file = std::make_unique<PatchOutputFile>(filebase + ".patch");
+    }
+    m_pipe_vtf_file.close();
+    m_pipe_patch_file.close();
+    if (buffer_frames > 0) {
+        for (int i {0}; i != buffer_frames; i++) {
+            m_free_frames.push_back(i);
+        }
+        m_writer = std::thread {&TrajectoryWriter::run_writer, this};
+    }
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    if (not m_writer.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock {m_frames_mutex};
+        m_finished = true;
+    }
+    m_frame_queued.notify_one();
+    m_writer.join();
+}
+
+void TrajectoryWriter::write_frame(Config& conf, stepT step) {
+    int frame_i {acquire_frame()};
+    m_frames[frame_i].snapshot(conf, step);
+    queue_frame(frame_i);
+}
+
+void TrajectoryWriter::write_frame(const ConfigFrame& frame) {
+    int frame_i {acquire_frame()};
+    m_frames[frame_i] = frame;
+    queue_frame(frame_i);
+}
+
+int TrajectoryWriter::acquire_frame() {
+    if (not m_writer.joinable()) {
+        return 0;
+    }
+
+    // Only wait if the writer is behind by every buffer
+    std::unique_lock<std::mutex> lock {m_frames_mutex};
+    m_frame_freed.wait(lock, [this] { return not m_free_frames.empty(); });
+    int frame_i {m_free_frames.front()};
+    m_free_frames.pop_front();
+
+    return frame_i;
+}
+
+void TrajectoryWriter::queue_frame(int frame_i) {
+    if (not m_writer.joinable()) {
+        write(m_frames[frame_i]);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock {m_frames_mutex};
+        m_queued_frames.push_back(frame_i);
+    }
+    m_frame_queued.notify_one();
+}
+
+void TrajectoryWriter::write(const ConfigFrame& frame) {
+    if (m_binary_file) {
+        m_binary_file->write_step(frame);
+    }
+    else {
+        m_vtf_file->write_step(frame);
+        m_patch_file->write_step(frame);
+    }
+    m_pipe_vtf_file.open_write_close(frame);
+    m_pipe_patch_file.open_write_step_close(frame);
+}
+
+void TrajectoryWriter::run_writer() {
+    while (true) {
+        int frame_i;
+        {
+            std::unique_lock<std::mutex> lock {m_frames_mutex};
+            m_frame_queued.wait(lock, [this] {
+                return m_finished or not m_queued_frames.empty();
+            });
+            if (m_queued_frames.empty()) {
+                return;
+            }
+            frame_i = m_queued_frames.front();
+            m_queued_frames.pop_front();
+        }
+        write(m_frames[frame_i]);
+        {
+            std::lock_guard<std::mutex> lock {m_frames_mutex};
+            m_free_frames.push_back(frame_i);
+        }
+        m_frame_freed.notify_one();
+    }
+}
 } // namespace ofile
@@ -1,7 +1,9 @@
 // param.cpp
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 #include "boost/program_options.hpp"
@@ -12,6 +14,7 @@ namespace param {
 
 namespace po = boost::program_options;
 
+using shared_types::InputError;
 using std::cout;
 
 Fraction::Fraction(string unparsed_fraction) {
@@ -42,10 +45,62 @@ InputParams::InputParams(int argc, char* argv[]) {
     po::options_description cl_options {"Command line options"};
     cl_options.add_options()(
             "parameter_filename,i", po::value<string>(), "Input file")(
+            "ensemble,e",
+            po::value<vector<string>>(&m_ensemble_filenames)->multitoken(),
+            "Input files of ensemble to run instead")(
+            "reps,r",
+            po::value<int>(&m_reps)->default_value(1),
+            "Number of reps of each ensemble input file")(
             "help,h", "Display available options");
     displayed_options.add(cl_options);
+    add_file_options(displayed_options);
 
-    // Parameter file options
+    // Parse command line input
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, displayed_options), vm);
+    po::notify(vm);
+    if (vm.count("help")) {
+        cout << "\n";
+        cout << displayed_options;
+        cout << "\n";
+        exit(1);
+    }
+
+    // Ensemble members are read separately
+    if (not m_ensemble_filenames.empty()) {
+        post_process_inputs();
+        return;
+    }
+    if (not vm.count("parameter_filename")) {
+        cout << "Input parameter file must be provided.\n";
+        std::exit(1);
+    }
+    string param_filename {vm["parameter_filename"].as<string>()};
+
+    // Parse parameter file input
+    std::ifstream param_file {param_filename};
+    po::store(po::parse_config_file(param_file, displayed_options), vm);
+    po::notify(vm);
+
+    post_process_inputs();
+}
+
+InputParams::InputParams(string param_filename): m_reps {1} {
+    std::ifstream param_file {param_filename};
+    if (not param_file) {
+        cout << "Could not open parameter file " << param_filename << "\n";
+        throw InputError {};
+    }
+    po::options_description file_options {};
+    add_file_options(file_options);
+    po::variables_map vm;
+    po::store(po::parse_config_file(param_file, file_options), vm);
+    po::notify(vm);
+
+    post_process_inputs();
+}
+
+void InputParams::add_file_options(po::options_description& options) {
     po::options_description inp_options {"System input"};
     inp_options.add_options()(
             "config_filename",
@@ -57,7 +112,7 @@ InputParams::InputParams(int argc, char* argv[]) {
             "temp",
             po::value<eneT>(&m_temp)->default_value(300),
             "Maximum dispacement for translations");
-    displayed_options.add(inp_options);
+    options.add(inp_options);
 
     po::options_description sim_options {"Simulation options"};
     sim_options.add_options()(
@@ -69,8 +124,32 @@ InputParams::InputParams(int argc, char* argv[]) {
             "Maximum duration")(
             "max_cutoff",
             po::value<distT>(&m_max_cutoff)->default_value(0),
-            "Maximum cutoff value of any included potential");
-    displayed_options.add(sim_options);
+            "Maximum cutoff value of any included potential (must be at "
+            "least the largest potential cutoff)")(
+            "verlet_skin",
+            po::value<distT>(&m_verlet_skin)->default_value(0),
+            "Skin for monomer Verlet lists (0 for cell lists only)")(
+            "energy_check_freq",
+            po::value<stepT>(&m_energy_check_freq)->default_value(0),
+            "Frequency of full energy recalculation to check drift")(
+            "fast_math",
+            po::value<bool>(&m_fast_math)->default_value(false),
+            "Use approximate acos and exp in angular potentials")(
+            "num_threads",
+            po::value<int>(&m_num_threads)->default_value(1),
+            "Number of threads for full energy calculations, replicas, "
+            "checkerboard sweeps, speculative batches or VMMC link "
+            "energies")(
+            "sim_type",
+            po::value<string>(&m_sim_type)->default_value("nvt"),
+            "Simulation type (nvt, ptmc or mpi_ptmc)")(
+            "temps",
+            po::value<string>(&m_temps_raw)->default_value(""),
+            "Replica temperatures for parallel tempering (space separated)")(
+            "exchange_freq",
+            po::value<stepT>(&m_exchange_freq)->default_value(100),
+            "Steps between replica exchange attempts");
+    options.add(sim_options);
 
     po::options_description move_options {"Movetype options"};
     move_options.add_options()(
@@ -83,6 +162,19 @@ InputParams::InputParams(int argc, char* argv[]) {
             "max_disp_a",
             po::value<distT>(&m_max_disp_a)->default_value(1),
             "Maximum displacement for selecting rotation angle")(
+            "tune_steps",
+            po::value<stepT>(&m_tune_steps)->default_value(0),
+            "Initial steps over which maximum displacements are tuned")(
+            "tune_interval",
+            po::value<stepT>(&m_tune_interval)->default_value(100),
+            "Attempts of a movetype between tunings of its displacements")(
+            "tune_target_accept",
+            po::value<double>(&m_tune_target_accept)->default_value(0.5),
+            "Acceptance ratio that displacements are tuned towards")(
+            "schedule_steps",
+            po::value<stepT>(&m_schedule_steps)->default_value(0),
+            "Steps after tuning over which movetype costs are measured to "
+            "set their probabilities")(
             "translation_met",
             po::value<string>(&m_translation_met_raw)->default_value("0"),
             "Probability of performing a translation Metropolis movetype")(
@@ -97,8 +189,36 @@ InputParams::InputParams(int argc, char* argv[]) {
             "Probability of performing a rotation VMMC")(
             "ntd_flip",
             po::value<string>(&m_ntd_flip_raw)->default_value("0"),
-            "Probability of performing a NTD flip");
-    displayed_options.add(move_options);
+            "Probability of performing a NTD flip")(
+            "translation_checkerboard",
+            po::value<string>(&m_translation_checkerboard_raw)
+                    ->default_value("0"),
+            "Probability of performing a parallel translation sweep")(
+            "rotation_checkerboard",
+            po::value<string>(&m_rotation_checkerboard_raw)->default_value("0"),
+            "Probability of performing a parallel rotation sweep")(
+            "ntd_flip_checkerboard",
+            po::value<string>(&m_ntd_flip_checkerboard_raw)->default_value("0"),
+            "Probability of performing a parallel NTD flip sweep")(
+            "translation_speculative",
+            po::value<string>(&m_translation_speculative_raw)
+                    ->default_value("0"),
+            "Probability of performing speculative parallel translations")(
+            "rotation_speculative",
+            po::value<string>(&m_rotation_speculative_raw)->default_value("0"),
+            "Probability of performing speculative parallel rotations")(
+            "ntd_flip_speculative",
+            po::value<string>(&m_ntd_flip_speculative_raw)->default_value("0"),
+            "Probability of performing speculative parallel NTD flips")(
+            "speculative_batch",
+            po::value<int>(&m_speculative_batch)->default_value(64),
+            "Number of monomers moved in each speculative parallel move")(
+            "sweep_movetypes",
+            po::value<string>(&m_sweep_movetypes_raw)->default_value(""),
+            "Movetypes that select monomers in sweeps in spatial order (space "
+            "separated of translation_met, rotation_met, translation_vmmc, "
+            "rotation_vmmc and ntd_flip)");
+    options.add(move_options);
 
     po::options_description output_options {"Output options"};
     output_options.add_options()(
@@ -113,31 +233,16 @@ InputParams::InputParams(int argc, char* argv[]) {
             "Configuration output frequency")(
             "op_output_freq",
             po::value<stepT>(&m_op_output_freq)->default_value(0),
-            "Order parameters output frequency");
-    displayed_options.add(output_options);
-
-    // Parse command line input
-    po::variables_map vm;
-    po::store(po::parse_command_line(argc, argv, displayed_options), vm);
-    po::notify(vm);
-    if (vm.count("help")) {
-        cout << "\n";
-        cout << displayed_options;
-        cout << "\n";
-        exit(1);
-    }
-    if (not vm.count("parameter_filename")) {
-        cout << "Input parameter file must be provided.\n";
-        std::exit(1);
-    }
-    string param_filename {vm["parameter_filename"].as<string>()};
-
-    // Parse parameter file input
-    std::ifstream param_file {param_filename};
-    po::store(po::parse_config_file(param_file, displayed_options), vm);
-    po::notify(vm);
-
-    post_process_inputs();
+            "Order parameters output frequency")(
+            "output_buffer_frames",
+            po::value<int>(&m_output_buffer_frames)->default_value(2),
+            "Configurations buffered for the output thread (0 writes on the "
+            "simulation thread)")(
+            "binary_trajectory",
+            po::value<bool>(&m_binary_trajectory)->default_value(false),
+            "Write the trajectory in the binary format instead of VTF and "
+            "patch files");
+    options.add(output_options);
 }
 
 void InputParams::post_process_inputs() {
@@ -153,5 +258,43 @@ void InputParams::post_process_inputs() {
     m_translation_vmmc = translation_vmmc_fraction.to_double();
     Fraction ntd_flip_fraction {m_ntd_flip_raw};
     m_ntd_flip = ntd_flip_fraction.to_double();
+    Fraction translation_checkerboard_fraction {
+            m_translation_checkerboard_raw};
+    m_translation_checkerboard = translation_checkerboard_fraction.to_double();
+    Fraction rotation_checkerboard_fraction {m_rotation_checkerboard_raw};
+    m_rotation_checkerboard = rotation_checkerboard_fraction.to_double();
+    Fraction ntd_flip_checkerboard_fraction {m_ntd_flip_checkerboard_raw};
+    m_ntd_flip_checkerboard = ntd_flip_checkerboard_fraction.to_double();
+    Fraction translation_speculative_fraction {m_translation_speculative_raw};
+    m_translation_speculative = translation_speculative_fraction.to_double();
+    Fraction rotation_speculative_fraction {m_rotation_speculative_raw};
+    m_rotation_speculative = rotation_speculative_fraction.to_double();
+    Fraction ntd_flip_speculative_fraction {m_ntd_flip_speculative_raw};
+    m_ntd_flip_speculative = ntd_flip_speculative_fraction.to_double();
+
+    // Parse replica temperatures
+    std::istringstream temps_stream {m_temps_raw};
+    eneT temp;
+    while (temps_stream >> temp) {
+        m_temps.push_back(temp);
+    }
+
+    // Parse sweep movetypes
+    vector<string> sweepable {
+            "translation_met",
+            "rotation_met",
+            "translation_vmmc",
+            "rotation_vmmc",
+            "ntd_flip"};
+    std::istringstream sweep_stream {m_sweep_movetypes_raw};
+    string movetype;
+    while (sweep_stream >> movetype) {
+        if (std::find(sweepable.begin(), sweepable.end(), movetype) ==
+            sweepable.end()) {
+            cout << "Movetype " << movetype << " cannot sweep\n";
+            throw InputError {};
+        }
+        m_sweep_movetypes.push_back(movetype);
+    }
 }
 } // namespace param
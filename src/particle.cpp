@@ -8,65 +8,106 @@ namespace particle {
 
 using std::cout;
 
+ParticleStore::ParticleStore() {}
+
+int ParticleStore::add_particle(vecT pos, Orientation ore) {
+    m_pos.push_back(pos);
+    m_trial_pos.push_back(pos);
+    m_ore.push_back(ore);
+    m_trial_ore.push_back(ore);
+
+    return m_pos.size() - 1;
+}
+
+int ParticleStore::get_num_particles() { return m_pos.size(); }
+
+vecT& ParticleStore::get_pos(int particle_i, CoorSet coorset) {
+    if (coorset == CoorSet::current) {
+        return m_pos[particle_i];
+    }
+    else {
+        return m_trial_pos[particle_i];
+    }
+}
+
+Orientation& ParticleStore::get_ore(int particle_i, CoorSet coorset) {
+    if (coorset == CoorSet::current) {
+        return m_ore[particle_i];
+    }
+    else {
+        return m_trial_ore[particle_i];
+    }
+}
+
+void ParticleStore::trial_to_current(int particle_i) {
+    m_pos[particle_i] = m_trial_pos[particle_i];
+    m_ore[particle_i] = m_trial_ore[particle_i];
+}
+
+void ParticleStore::current_to_trial(int particle_i) {
+    m_trial_pos[particle_i] = m_pos[particle_i];
+    m_trial_ore[particle_i] = m_ore[particle_i];
+}
+
 Particle::Particle(
         int index,
         int type,
         vecT pos,
         Orientation ore,
         CuboidPBC& pbc_space):
-        m_ore {ore},
-        m_trial_ore {ore},
         m_index {index},
         m_type {type},
-        m_pos {pos},
-        m_trial_pos {pos},
+        m_own_store {new ParticleStore()},
+        m_store {*m_own_store},
+        m_store_i {m_store.add_particle(pos, ore)},
+        m_space {pbc_space} {}
+
+Particle::Particle(
+        int index,
+        int type,
+        vecT pos,
+        Orientation ore,
+        CuboidPBC& pbc_space,
+        ParticleStore& store):
+        m_index {index},
+        m_type {type},
+        m_store {store},
+        m_store_i {m_store.add_particle(pos, ore)},
         m_space {pbc_space} {}
 
 int Particle::get_index() { return m_index; }
 
 int Particle::get_type() { return m_type; }
 
+int Particle::get_store_index() { return m_store_i; }
+
 vecT& Particle::get_pos(CoorSet coorset) {
-    if (coorset == CoorSet::current) {
-        return m_pos;
-    }
-    else {
-        return m_trial_pos;
-    }
+    return m_store.get_pos(m_store_i, coorset);
 }
 
 Orientation& Particle::get_ore(CoorSet coorset) {
-    if (coorset == CoorSet::current) {
-        return m_ore;
-    }
-    else {
-        return m_trial_ore;
-    }
+    return m_store.get_ore(m_store_i, coorset);
 }
 
-void Particle::set_pos(vecT pos) { m_pos = pos; }
+void Particle::set_pos(vecT pos) { get_pos(CoorSet::current) = pos; }
 
 void Particle::translate(vecT& disv) {
-    m_trial_pos = m_pos + disv;
-    m_trial_pos = m_space.wrap(m_trial_pos);
+    vecT& trial_pos {get_pos(CoorSet::trial)};
+    trial_pos = get_pos(CoorSet::current) + disv;
+    trial_pos = m_space.wrap(trial_pos);
 }
 
 void Particle::rotate(vecT& rot_c, rotMatT& rot_mat) {
-    m_trial_pos -= rot_c;
-    m_trial_pos = rot_mat * m_trial_pos;
-    m_trial_pos += rot_c;
-    m_trial_pos = m_space.wrap(m_trial_pos);
+    vecT& trial_pos {get_pos(CoorSet::trial)};
+    trial_pos -= rot_c;
+    trial_pos = rot_mat * trial_pos;
+    trial_pos += rot_c;
+    trial_pos = m_space.wrap(trial_pos);
 }
 
-void Particle::trial_to_current() {
-    m_pos = m_trial_pos;
-    m_ore = m_trial_ore;
-}
+void Particle::trial_to_current() { m_store.trial_to_current(m_store_i); }
 
-void Particle::current_to_trial() {
-    m_trial_pos = m_pos;
-    m_trial_ore = m_ore;
-}
+void Particle::current_to_trial() { m_store.current_to_trial(m_store_i); }
 
 PatchyParticle::PatchyParticle(
         int index,
@@ -76,9 +117,20 @@ PatchyParticle::PatchyParticle(
         CuboidPBC& pbc_space):
         Particle {index, type, pos, ore, pbc_space} {}
 
+PatchyParticle::PatchyParticle(
+        int index,
+        int type,
+        vecT pos,
+        Orientation ore,
+        CuboidPBC& pbc_space,
+        ParticleStore& store):
+        Particle {index, type, pos, ore, pbc_space, store} {}
+
 void PatchyParticle::rotate(vecT& rot_c, rotMatT& rot_mat) {
     Particle::rotate(rot_c, rot_mat);
-    m_trial_ore.patch_norm = rot_mat * m_ore.patch_norm;
+    Orientation& ore {get_ore(CoorSet::current)};
+    Orientation& trial_ore {get_ore(CoorSet::trial)};
+    trial_ore.patch_norm = rot_mat * ore.patch_norm;
 }
 
 OrientedPatchyParticle::OrientedPatchyParticle(
@@ -89,9 +141,20 @@ OrientedPatchyParticle::OrientedPatchyParticle(
         CuboidPBC& pbc_space):
         PatchyParticle {index, type, pos, ore, pbc_space} {}
 
+OrientedPatchyParticle::OrientedPatchyParticle(
+        int index,
+        int type,
+        vecT pos,
+        Orientation ore,
+        CuboidPBC& pbc_space,
+        ParticleStore& store):
+        PatchyParticle {index, type, pos, ore, pbc_space, store} {}
+
 void OrientedPatchyParticle::rotate(vecT& rot_c, rotMatT& rot_mat) {
     PatchyParticle::rotate(rot_c, rot_mat);
-    m_trial_ore.patch_orient = rot_mat * m_ore.patch_orient;
+    Orientation& ore {get_ore(CoorSet::current)};
+    Orientation& trial_ore {get_ore(CoorSet::trial)};
+    trial_ore.patch_orient = rot_mat * ore.patch_orient;
 }
 
 DoubleOrientedPatchyParticle::DoubleOrientedPatchyParticle(
@@ -102,9 +165,20 @@ DoubleOrientedPatchyParticle::DoubleOrientedPatchyParticle(
         CuboidPBC& pbc_space):
         PatchyParticle {index, type, pos, ore, pbc_space} {}
 
+DoubleOrientedPatchyParticle::DoubleOrientedPatchyParticle(
+        int index,
+        int type,
+        vecT pos,
+        Orientation ore,
+        CuboidPBC& pbc_space,
+        ParticleStore& store):
+        PatchyParticle {index, type, pos, ore, pbc_space, store} {}
+
 void DoubleOrientedPatchyParticle::rotate(vecT& rot_c, rotMatT& rot_mat) {
     PatchyParticle::rotate(rot_c, rot_mat);
-    m_trial_ore.patch_orient = rot_mat * m_ore.patch_orient;
-    m_trial_ore.patch_orient2 = rot_mat * m_ore.patch_orient2;
+    Orientation& ore {get_ore(CoorSet::current)};
+    Orientation& trial_ore {get_ore(CoorSet::trial)};
+    trial_ore.patch_orient = rot_mat * ore.patch_orient;
+    trial_ore.patch_orient2 = rot_mat * ore.patch_orient2;
 }
 } // namespace particle
@@ -50,6 +50,8 @@ bool PairPotential::particles_interacting(distT rdist) {
     return interacting;
 }
 
+distT PairPotential::get_rcut() { return m_rcut; }
+
 ZeroPotential::ZeroPotential(): PairPotential {0} {}
 
 eneT ZeroPotential::calc_energy(distT, vecT&, Orientation&, Orientation&) {
@@ -0,0 +1,224 @@
+// potential_batch.cpp
+
+#include <cmath>
+#include <type_traits>
+#include <variant>
+
+#include "BlobCrystallinOligomer/potential_batch.h"
+
+namespace potential {
+
+using Eigen::ArrayXd;
+using Eigen::Map;
+
+typedef Map<ArrayXd> arrayMapT;
+
+void PairBatch::add_pair(
+        distT pair_rdist,
+        const vecT& p_diff,
+        const Orientation& ore1,
+        const Orientation& ore2) {
+
+    rdist.push_back(pair_rdist);
+    for (int i {0}; i != 3; i++) {
+        diff[i].push_back(p_diff[i]);
+        norm1[i].push_back(ore1.patch_norm[i]);
+        norm2[i].push_back(ore2.patch_norm[i]);
+        orient1[i].push_back(ore1.patch_orient[i]);
+        orient2[i].push_back(ore2.patch_orient[i]);
+        second_orient1[i].push_back(ore1.patch_orient2[i]);
+        second_orient2[i].push_back(ore2.patch_orient2[i]);
+    }
+}
+
+void PairBatch::clear() {
+    rdist.clear();
+    for (int i {0}; i != 3; i++) {
+        diff[i].clear();
+        norm1[i].clear();
+        norm2[i].clear();
+        orient1[i].clear();
+        orient2[i].clear();
+        second_orient1[i].clear();
+        second_orient2[i].clear();
+    }
+}
+
+int PairBatch::size() { return rdist.size(); }
+
+namespace {
+
+arrayMapT map(vector<distT>& column, int size) {
+    if (static_cast<int>(column.size()) < size) {
+        column.resize(size);
+    }
+
+    return arrayMapT {column.data(), size};
+}
+
+/** Dot product of a batch of vectors stored component-wise */
+void dot(
+        vector<distT> (&u)[3],
+        vector<distT> (&v)[3],
+        int n,
+        arrayMapT& result) {
+
+    result = map(u[0], n) * map(v[0], n) + map(u[1], n) * map(v[1], n) +
+             map(u[2], n) * map(v[2], n);
+}
+
+/** Angle from cosines clamped against rounding outside [-1, 1]
+ *
+ * There is no packet acos, so this is evaluated element-wise. The
+ * polynomial of fast_acos is branch free and so can be vectorized.
+ */
+void clamped_acos(arrayMapT& cosines, bool fast_math) {
+    cosines = cosines.max(-1).min(1);
+    if (fast_math) {
+        for (int i {0}; i != cosines.size(); i++) {
+            cosines[i] = fast_acos(cosines[i]);
+        }
+    }
+    else {
+        for (int i {0}; i != cosines.size(); i++) {
+            cosines[i] = std::acos(cosines[i]);
+        }
+    }
+}
+
+/** Dihedral angles of patch vectors u and v about the unit separations */
+void dihedrals(
+        vector<distT> (&u)[3],
+        vector<distT> (&v)[3],
+        vector<distT> (&unit)[3],
+        int n,
+        arrayMapT& theta,
+        bool fast_math,
+        PairBatch& batch) {
+
+    arrayMapT u_dot {map(batch.work[3], n)};
+    arrayMapT v_dot {map(batch.work[4], n)};
+    arrayMapT rej_dot {map(batch.work[5], n)};
+    arrayMapT u_rej_norm2 {map(batch.work[6], n)};
+    arrayMapT v_rej_norm2 {map(batch.work[7], n)};
+    dot(u, unit, n, u_dot);
+    dot(v, unit, n, v_dot);
+    rej_dot.setZero();
+    u_rej_norm2.setZero();
+    v_rej_norm2.setZero();
+    arrayMapT u_rej {map(batch.work[8], n)};
+    arrayMapT v_rej {map(batch.work[9], n)};
+    for (int i {0}; i != 3; i++) {
+        arrayMapT unit_i {map(unit[i], n)};
+        u_rej = map(u[i], n) - u_dot * unit_i;
+        v_rej = map(v[i], n) - v_dot * unit_i;
+        rej_dot += u_rej * v_rej;
+        u_rej_norm2 += u_rej.square();
+        v_rej_norm2 += v_rej.square();
+    }
+    theta = rej_dot / (u_rej_norm2.sqrt() * v_rej_norm2.sqrt());
+    clamped_acos(theta, fast_math);
+}
+} // namespace
+
+bool kernel_batchable(const PotentialKernel& kernel) {
+    return std::holds_alternative<ShiftedLJKernel>(kernel) or
+           std::holds_alternative<PatchyKernel>(kernel) or
+           std::holds_alternative<OrientedPatchyKernel>(kernel) or
+           std::holds_alternative<DoubleOrientedPatchyKernel>(kernel);
+}
+
+eneT calc_batch_energy(const PotentialKernel& kernel, PairBatch& batch) {
+    return std::visit(
+            [&](const auto& kern) -> eneT {
+                using kernelT = std::decay_t<decltype(kern)>;
+                if constexpr (
+                        std::is_same_v<kernelT, ShiftedLJKernel> or
+                        std::is_same_v<kernelT, PatchyKernel> or
+                        std::is_same_v<kernelT, OrientedPatchyKernel> or
+                        std::is_same_v<kernelT, DoubleOrientedPatchyKernel>) {
+                    return calc_batch_energy(kern, batch);
+                }
+                else {
+                    return 0;
+                }
+            },
+            kernel);
+}
+
+eneT calc_batch_energy(const ShiftedLJKernel& kernel, PairBatch& batch) {
+    int n {batch.size()};
+    arrayMapT sig_r_ratio6 {map(batch.work[0], n)};
+    sig_r_ratio6 = (kernel.sigl / map(batch.rdist, n)).square().cube();
+    eneT ene {
+            (kernel.four_eps * (sig_r_ratio6.square() - sig_r_ratio6) -
+             kernel.shift)
+                    .sum()};
+
+    return ene;
+}
+
+template<int num_dihedrals>
+eneT calc_batch_energy(
+        const PatchyKernelT<num_dihedrals>& kernel,
+        PairBatch& batch) {
+
+    int n {batch.size()};
+    arrayMapT rdist {map(batch.rdist, n)};
+
+    // Radial part
+    arrayMapT lj_ene {map(batch.work[0], n)};
+    lj_ene = (kernel.lj.sigl / rdist).square().cube();
+    lj_ene = kernel.lj.four_eps * (lj_ene.square() - lj_ene) - kernel.lj.shift;
+
+    // Unit separations overwrite the separations, which are not needed again
+    for (int i {0}; i != 3; i++) {
+        map(batch.diff[i], n) /= rdist;
+    }
+
+    // All Gaussian factors are combined in a single exponent, which already
+    // uses the packet exp, so fast_math only changes the acos evaluations
+    arrayMapT exponent {map(batch.work[1], n)};
+    arrayMapT theta {map(batch.work[2], n)};
+    dot(batch.diff, batch.norm1, n, theta);
+    clamped_acos(theta, kernel.fast_math);
+    exponent = theta.square() / kernel.two_siga1_2;
+    dot(batch.diff, batch.norm2, n, theta);
+    theta = -theta;
+    clamped_acos(theta, kernel.fast_math);
+    exponent += theta.square() / kernel.two_siga2_2;
+    if constexpr (num_dihedrals > 0) {
+        dihedrals(
+                batch.orient1,
+                batch.orient2,
+                batch.diff,
+                n,
+                theta,
+                kernel.fast_math,
+                batch);
+        exponent += theta.square() / kernel.two_sigt2;
+    }
+    if constexpr (num_dihedrals > 1) {
+        dihedrals(
+                batch.second_orient1,
+                batch.second_orient2,
+                batch.diff,
+                n,
+                theta,
+                kernel.fast_math,
+                batch);
+        exponent += theta.square() / kernel.two_sigt2;
+    }
+
+    // Within the repulsive core only the radial part applies
+    eneT ene {(rdist < kernel.sigl)
+                      .select(lj_ene, lj_ene * (-exponent).exp())
+                      .sum()};
+
+    return ene;
+}
+
+template eneT calc_batch_energy(const PatchyKernel&, PairBatch&);
+template eneT calc_batch_energy(const OrientedPatchyKernel&, PairBatch&);
+template eneT calc_batch_energy(const DoubleOrientedPatchyKernel&, PairBatch&);
+} // namespace potential
@@ -1,89 +1,253 @@
 // simulation.cpp
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <exception>
+#include <fstream>
 #include <iostream>
+#include <string>
 
 #include "BlobCrystallinOligomer/simulation.h"
 
 namespace simulation {
 
+using movetype::CheckerboardMetMCMovetype;
 using movetype::MetMCMovetype;
+using movetype::SpeculativeMetMCMovetype;
 using movetype::VMMCMovetype;
+using shared_types::InputError;
 using std::cout;
+using std::make_shared;
+using std::make_unique;
 using std::setw;
 using std::chrono::steady_clock;
 
+double calc_autocorrelation_time(const vector<double>& series) {
+    int n {static_cast<int>(series.size())};
+    double mean {0};
+    for (double x: series) {
+        mean += x;
+    }
+    mean /= n;
+    double var {0};
+    for (double x: series) {
+        var += (x - mean) * (x - mean);
+    }
+    if (n < 2 or var == 0) {
+        return std::nan("");
+    }
+    double tau {1};
+    for (int lag {1}; lag < n / 2; lag++) {
+        double cov {0};
+        for (int i {0}; i != n - lag; i++) {
+            cov += (series[i] - mean) * (series[i + lag] - mean);
+        }
+        double rho {cov / var};
+        if (rho <= 0) {
+            break;
+        }
+        tau += 2 * rho;
+    }
+
+    return tau;
+}
+
+RunningEnergy::RunningEnergy(eneT ene): m_sum {ene} {}
+
+void RunningEnergy::add(eneT de) {
+    eneT sum {m_sum + de};
+    if (std::fabs(m_sum) >= std::fabs(de)) {
+        m_compensation += (m_sum - sum) + de;
+    }
+    else {
+        m_compensation += (de - sum) + m_sum;
+    }
+    m_sum = sum;
+}
+
+eneT RunningEnergy::get_total() { return m_sum + m_compensation; }
+
+void RunningEnergy::reset(eneT ene) {
+    m_sum = ene;
+    m_compensation = 0;
+}
+
 NVTMCSimulation::NVTMCSimulation(
         Config& conf,
         Energy& ene,
         InputParams params,
-        RandomGens& random_num):
+        RandomGens& random_num,
+        ostream& log):
         m_config {conf},
         m_energy {ene},
         m_random_num {random_num},
+        m_log {log},
         m_beta {1 / params.m_temp},
+        m_total_ene {ene.calc_total_energy()},
         m_steps {params.m_steps},
         m_duration {params.m_duration},
+        m_energy_check_freq {params.m_energy_check_freq},
         m_logging_freq {params.m_logging_freq},
         m_config_output_freq {params.m_config_output_freq},
         m_op_output_freq {params.m_op_output_freq},
-        m_vtf_file {params.m_output_filebase + ".vtf", conf},
-        m_patch_file {params.m_output_filebase + ".patch"},
-        m_pipe_vtf_file {params.m_output_filebase + "_pipe.vtf", conf},
-        m_pipe_patch_file {params.m_output_filebase + "_pipe.patch"} {
+        m_tune_steps {params.m_tune_steps},
+        m_tune_interval {params.m_tune_interval},
+        m_tune_target_accept {params.m_tune_target_accept},
+        m_schedule_steps {params.m_schedule_steps} {
 
-    m_pipe_vtf_file.close();
-    m_pipe_patch_file.close();
+    if (m_tune_steps and m_tune_interval == 0) {
+        cout << "Tuning interval must be nonzero\n";
+        throw InputError {};
+    }
+    if (m_tune_target_accept <= 0 or m_tune_target_accept >= 1) {
+        cout << "Target acceptance ratio must be between 0 and 1\n";
+        throw InputError {};
+    }
+
+    if (m_config_output_freq) {
+        m_traj_writer = make_unique<TrajectoryWriter>(
+                params.m_output_filebase,
+                conf,
+                params.m_output_buffer_frames,
+                params.m_binary_trajectory);
+    }
     construct_movetypes(params);
+    m_sample_freq = std::max(conf.get_num_monomers(), 1);
+    m_start_time = steady_clock::now();
 }
 
 void NVTMCSimulation::run() {
+    m_energy.set_serial_level();
     auto start = steady_clock::now();
     for (stepT step {1}; step != (m_steps + 1); step++) {
-
-        // Do a move
-        int movetype_i {select_movetype()};
-        MCMovetype& movetype {*m_movetypes[movetype_i]};
-        bool accepted {movetype.move()};
-        m_move_attempts[movetype_i]++;
-        m_move_accepts[movetype_i] += accepted;
+        run_step(step);
 
         // Check if maximum allowed time reached
         std::chrono::duration<double> dt {(steady_clock::now() - start)};
         if (dt.count() > m_duration) {
-            cout << "Maximum time allowed reached\n";
+            m_log << "Maximum time allowed reached\n";
             break;
         }
+    }
+    log_summary();
+}
 
-        // Log
-        if (m_logging_freq and step % m_logging_freq == 0) {
-            log_move(step, movetype.get_label(), accepted);
+void NVTMCSimulation::run_steps(stepT first_step, stepT num_steps) {
+    m_energy.set_serial_level();
+    for (stepT step {first_step}; step != first_step + num_steps; step++) {
+        run_step(step);
+    }
+}
+
+void NVTMCSimulation::set_temp(eneT temp) {
+    m_beta = 1 / temp;
+    for (auto& movetype: m_movetypes) {
+        movetype->set_beta(m_beta);
+    }
+}
+
+eneT NVTMCSimulation::get_energy() { return m_total_ene.get_total(); }
+
+void NVTMCSimulation::run_step(stepT step) {
+
+    // Do a move
+    int movetype_i {select_movetype()};
+    MCMovetype& movetype {*m_movetypes[movetype_i]};
+    stepT schedule_end {m_tune_steps + m_schedule_steps};
+    bool scheduling {step > m_tune_steps and step <= schedule_end};
+    steady_clock::time_point move_start {};
+    if (scheduling) {
+        move_start = steady_clock::now();
+    }
+    bool accepted {movetype.move()};
+    if (scheduling) {
+        std::chrono::duration<double> dt {steady_clock::now() - move_start};
+        m_schedule_times[movetype_i] += dt.count();
+        m_schedule_disp2s[movetype_i] += movetype.get_disp2();
+        m_schedule_attempts[movetype_i]++;
+        if (step == schedule_end) {
+            schedule_movetypes();
         }
+    }
+    m_move_attempts[movetype_i]++;
+    m_move_accepts[movetype_i] += accepted;
+    if (accepted) {
+        m_total_ene.add(movetype.get_de());
+    }
+    m_steps_run++;
+    if (step % m_sample_freq == 0) {
+        m_ene_samples.push_back(m_total_ene.get_total());
+    }
 
-        // Output configuration and order parameters
-        if (m_config_output_freq and step % m_config_output_freq == 0) {
-            m_vtf_file.write_step(m_config, step);
-            m_patch_file.write_step(m_config);
-            m_pipe_vtf_file.open_write_close(m_config, step);
-            m_pipe_patch_file.open_write_step_close(m_config);
+    // Tune displacements during equilibration
+    if (step <= m_tune_steps) {
+        tune_movetype(movetype_i, accepted);
+        if (step == m_tune_steps) {
+            log_amplitudes();
         }
-        // if (m_op_output_freq and step % m_op_output_freq) {
-        //  Write op to file
-        //}
     }
-    log_summary();
+
+    // Check energy
+    if (m_energy_check_freq and step % m_energy_check_freq == 0) {
+        check_energy(step);
+    }
+
+    // Log
+    if (m_logging_freq and step % m_logging_freq == 0) {
+        log_move(step, movetype.get_label(), accepted);
+    }
+
+    // Output configuration and order parameters
+    if (m_config_output_freq and step % m_config_output_freq == 0) {
+        m_traj_writer->write_frame(m_config, step);
+    }
+    // if (m_op_output_freq and step % m_op_output_freq) {
+    //  Write op to file
+    //}
+}
+
+void NVTMCSimulation::tune_movetype(int movetype_i, bool accepted) {
+    m_tune_attempts[movetype_i]++;
+    m_tune_accepts[movetype_i] += accepted;
+    if (m_tune_attempts[movetype_i] != m_tune_interval) {
+        return;
+    }
+    double accept_ratio {
+            static_cast<double>(m_tune_accepts[movetype_i]) /
+            m_tune_attempts[movetype_i]};
+    double factor {std::clamp(accept_ratio / m_tune_target_accept, 0.5, 2.0)};
+    m_movetypes[movetype_i]->scale_amplitudes(factor);
+    m_tune_attempts[movetype_i] = 0;
+    m_tune_accepts[movetype_i] = 0;
+}
+
+void NVTMCSimulation::log_amplitudes() {
+    m_log << "Tuned maximum displacements"
+          << "\n";
+    for (auto& movetype: m_movetypes) {
+        m_log << movetype->get_label() << "\n";
+        movetype->write_amplitudes(m_log);
+    }
+    m_log << "\n";
 }
 
 void NVTMCSimulation::construct_movetypes(InputParams params) {
     // This is pretty ugly
     // Also creates the cumalitive probability array
     double cum_prob {0};
+    auto sweeps = [&params](string movetype) {
+        vector<string>& movetypes {params.m_sweep_movetypes};
+        return std::find(movetypes.begin(), movetypes.end(), movetype) !=
+               movetypes.end();
+    };
     if (params.m_translation_met) {
         MCMovetype* movetype;
         string label {"TranslationMetMCMovetype"};
         string movemap_type {"translation"};
         movetype = new MetMCMovetype {
                 m_config, m_energy, m_random_num, params, label, movemap_type};
+        movetype->set_sweep(sweeps("translation_met"));
         m_movetypes.emplace_back(movetype);
         cum_prob += params.m_translation_met;
         m_cum_probs.push_back(cum_prob);
@@ -94,6 +258,7 @@ void NVTMCSimulation::construct_movetypes(InputParams params) {
         string movemap_type {"rotation"};
         movetype = new MetMCMovetype {
                 m_config, m_energy, m_random_num, params, label, movemap_type};
+        movetype->set_sweep(sweeps("rotation_met"));
         m_movetypes.emplace_back(movetype);
         cum_prob += params.m_rotation_met;
         m_cum_probs.push_back(cum_prob);
@@ -104,6 +269,7 @@ void NVTMCSimulation::construct_movetypes(InputParams params) {
         string movemap_type {"translation"};
         movetype = new VMMCMovetype {
                 m_config, m_energy, m_random_num, params, label, movemap_type};
+        movetype->set_sweep(sweeps("translation_vmmc"));
         m_movetypes.emplace_back(movetype);
         cum_prob += params.m_translation_vmmc;
         m_cum_probs.push_back(cum_prob);
@@ -114,6 +280,7 @@ void NVTMCSimulation::construct_movetypes(InputParams params) {
         string movemap_type {"rotation"};
         movetype = new VMMCMovetype {
                 m_config, m_energy, m_random_num, params, label, movemap_type};
+        movetype->set_sweep(sweeps("rotation_vmmc"));
         m_movetypes.emplace_back(movetype);
         cum_prob += params.m_rotation_vmmc;
         m_cum_probs.push_back(cum_prob);
@@ -124,52 +291,415 @@ void NVTMCSimulation::construct_movetypes(InputParams params) {
         string movemap_type {"ntdflip"};
         movetype = new MetMCMovetype {
                 m_config, m_energy, m_random_num, params, label, movemap_type};
+        movetype->set_sweep(sweeps("ntd_flip"));
         m_movetypes.emplace_back(movetype);
         cum_prob += params.m_ntd_flip;
         m_cum_probs.push_back(cum_prob);
     }
+    if (params.m_translation_checkerboard) {
+        MCMovetype* movetype;
+        string label {"TranslationCheckerboardMCMovetype"};
+        string movemap_type {"translation"};
+        movetype = new CheckerboardMetMCMovetype {
+                m_config, m_energy, m_random_num, params, label, movemap_type};
+        m_movetypes.emplace_back(movetype);
+        cum_prob += params.m_translation_checkerboard;
+        m_cum_probs.push_back(cum_prob);
+    }
+    if (params.m_rotation_checkerboard) {
+        MCMovetype* movetype;
+        string label {"RotationCheckerboardMCMovetype"};
+        string movemap_type {"rotation"};
+        movetype = new CheckerboardMetMCMovetype {
+                m_config, m_energy, m_random_num, params, label, movemap_type};
+        m_movetypes.emplace_back(movetype);
+        cum_prob += params.m_rotation_checkerboard;
+        m_cum_probs.push_back(cum_prob);
+    }
+    if (params.m_ntd_flip_checkerboard) {
+        MCMovetype* movetype;
+        string label {"NTDFlipCheckerboardMCMovetype"};
+        string movemap_type {"ntdflip"};
+        movetype = new CheckerboardMetMCMovetype {
+                m_config, m_energy, m_random_num, params, label, movemap_type};
+        m_movetypes.emplace_back(movetype);
+        cum_prob += params.m_ntd_flip_checkerboard;
+        m_cum_probs.push_back(cum_prob);
+    }
+    if (params.m_translation_speculative) {
+        MCMovetype* movetype;
+        string label {"TranslationSpeculativeMCMovetype"};
+        string movemap_type {"translation"};
+        movetype = new SpeculativeMetMCMovetype {
+                m_config, m_energy, m_random_num, params, label, movemap_type};
+        m_movetypes.emplace_back(movetype);
+        cum_prob += params.m_translation_speculative;
+        m_cum_probs.push_back(cum_prob);
+    }
+    if (params.m_rotation_speculative) {
+        MCMovetype* movetype;
+        string label {"RotationSpeculativeMCMovetype"};
+        string movemap_type {"rotation"};
+        movetype = new SpeculativeMetMCMovetype {
+                m_config, m_energy, m_random_num, params, label, movemap_type};
+        m_movetypes.emplace_back(movetype);
+        cum_prob += params.m_rotation_speculative;
+        m_cum_probs.push_back(cum_prob);
+    }
+    if (params.m_ntd_flip_speculative) {
+        MCMovetype* movetype;
+        string label {"NTDFlipSpeculativeMCMovetype"};
+        string movemap_type {"ntdflip"};
+        movetype = new SpeculativeMetMCMovetype {
+                m_config, m_energy, m_random_num, params, label, movemap_type};
+        m_movetypes.emplace_back(movetype);
+        cum_prob += params.m_ntd_flip_speculative;
+        m_cum_probs.push_back(cum_prob);
+    }
 
     // Prepare vectors that track movetype information
     for (size_t i {0}; i != m_movetypes.size(); i++) {
         m_move_attempts.push_back(0);
         m_move_accepts.push_back(0);
+        m_tune_attempts.push_back(0);
+        m_tune_accepts.push_back(0);
+        m_schedule_times.push_back(0);
+        m_schedule_disp2s.push_back(0);
+        m_schedule_attempts.push_back(0);
     }
 }
 
 int NVTMCSimulation::select_movetype() {
     double prob {m_random_num.uniform_real()};
-    size_t i;
-    for (i = 0; i != m_cum_probs.size(); i++) {
-        if (prob < m_cum_probs[i]) {
-            break;
+    auto it {std::upper_bound(m_cum_probs.begin(), m_cum_probs.end(), prob)};
+
+    return it - m_cum_probs.begin();
+}
+
+double NVTMCSimulation::get_movetype_prob(int movetype_i) {
+    return m_cum_probs[movetype_i] -
+           (movetype_i == 0 ? 0 : m_cum_probs[movetype_i - 1]);
+}
+
+void NVTMCSimulation::schedule_movetypes() {
+
+    // Efficiencies as accepted squared displacement per second
+    int num_movetypes {static_cast<int>(m_movetypes.size())};
+    vector<double> probs(num_movetypes);
+    vector<double> effs(num_movetypes, 0);
+    double mean_eff {0};
+    for (int i {0}; i != num_movetypes; i++) {
+        probs[i] = get_movetype_prob(i);
+        if (m_schedule_times[i] > 0) {
+            effs[i] = m_schedule_disp2s[i] / m_schedule_times[i];
+        }
+        mean_eff += probs[i] * effs[i];
+    }
+    double total_prob {m_cum_probs.back()};
+    mean_eff /= total_prob;
+
+    // Weight given probabilities by relative efficiency
+    if (mean_eff > 0) {
+        vector<double> weights(num_movetypes);
+        double total_weight {0};
+        for (int i {0}; i != num_movetypes; i++) {
+            weights[i] = probs[i] * std::max(effs[i] / mean_eff, 0.1);
+            total_weight += weights[i];
+        }
+        double cum_prob {0};
+        for (int i {0}; i != num_movetypes; i++) {
+            cum_prob += weights[i] / total_weight * total_prob;
+            m_cum_probs[i] = cum_prob;
         }
     }
 
-    return i;
+    m_log << "Scheduled movetypes"
+          << "\n";
+    m_log << setw(34) << "Movetype";
+    m_log << setw(14) << "Time";
+    m_log << setw(14) << "Disp2/s";
+    m_log << setw(14) << "Probability"
+          << "\n";
+    for (int i {0}; i != num_movetypes; i++) {
+        m_log << setw(34) << m_movetypes[i]->get_label();
+        m_log << setw(14) << m_schedule_times[i] / m_schedule_attempts[i];
+        m_log << setw(14) << effs[i];
+        m_log << setw(14) << get_movetype_prob(i) << "\n";
+    }
+    m_log << "\n";
 }
 
 void NVTMCSimulation::log_move(stepT step, string label, bool accepted) {
+    m_log << "Step: " << step << "\n";
+    m_log << "Movetype: " << label << "\n";
+    m_log << "Accepted: " << accepted << "\n";
+    m_log << "Energy: " << m_total_ene.get_total() << "\n";
+    m_log << "\n";
+}
+
+void NVTMCSimulation::check_energy(stepT step) {
+    eneT ene {m_energy.calc_total_energy()};
+    eneT drift {m_total_ene.get_total() - ene};
+    m_log << "Step: " << step << "\n";
+    m_log << "Calculated energy: " << ene << "\n";
+    m_log << "Energy drift: " << drift << "\n";
+    m_log << "\n";
+    m_total_ene.reset(ene);
+}
+
+void NVTMCSimulation::log_summary() {
+    m_log << "Run summary"
+          << "\n";
+    m_log << "Movetype" << setw(10);
+    m_log << "Attempts" << setw(10);
+    m_log << "Accepts" << setw(10);
+    m_log << "Frequency"
+          << "\n";
+    for (size_t i {0}; i != m_movetypes.size(); i++) {
+        m_log << m_movetypes[i]->get_label() << setw(10);
+        m_log << m_move_attempts[i] << setw(10);
+        m_log << m_move_accepts[i] << setw(10);
+        m_log << static_cast<double>(m_move_accepts[i]) / m_move_attempts[i]
+              << "\n";
+    }
+    std::chrono::duration<double> dt {steady_clock::now() - m_start_time};
+    m_log << "\n";
+    m_log << "Steps per second: " << m_steps_run / dt.count() << "\n";
+    m_log << "Energy autocorrelation time (sweeps): "
+          << calc_autocorrelation_time(m_ene_samples) << "\n";
+    if (m_schedule_steps) {
+        m_log << "\n";
+        m_log << setw(34) << "Movetype";
+        m_log << setw(14) << "Probability"
+              << "\n";
+        for (size_t i {0}; i != m_movetypes.size(); i++) {
+            m_log << setw(34) << m_movetypes[i]->get_label();
+            m_log << setw(14) << get_movetype_prob(i) << "\n";
+        }
+    }
+}
+
+namespace {
+
+/** Check if a multiple of freq is in (step - num_steps, step] */
+bool multiple_passed(stepT step, stepT num_steps, stepT freq) {
+    return freq and step / freq != (step - num_steps) / freq;
+}
+} // namespace
+
+PTMCSimulation::PTMCSimulation(InputParams params):
+        m_temps {params.m_temps},
+        m_steps {params.m_steps},
+        m_duration {params.m_duration},
+        m_exchange_freq {params.m_exchange_freq},
+        m_energy_check_freq {params.m_energy_check_freq},
+        m_logging_freq {params.m_logging_freq},
+        m_num_threads {std::max(params.m_num_threads, 1)} {
+
+    if (m_temps.size() < 2) {
+        cout << "Parallel tempering requires at least two temperatures\n";
+        throw InputError {};
+    }
+    if (not std::is_sorted(m_temps.begin(), m_temps.end())) {
+        cout << "Parallel tempering temperatures must be increasing\n";
+        throw InputError {};
+    }
+    if (m_exchange_freq == 0) {
+        cout << "Exchange frequency must be nonzero\n";
+        throw InputError {};
+    }
+
+    // Replicas are run in parallel, and are checked and logged from here
+    InputParams replica_params {params};
+    replica_params.m_num_threads = 1;
+    replica_params.m_energy_check_freq = 0;
+    replica_params.m_logging_freq = 0;
+    for (size_t i {0}; i != m_temps.size(); i++) {
+        replica_params.m_temp = m_temps[i];
+        replica_params.m_output_filebase =
+                params.m_output_filebase + "-" + std::to_string(i);
+        m_random_nums.push_back(make_unique<RandomGens>());
+        m_configs.push_back(
+                make_unique<Config>(replica_params, *m_random_nums.back()));
+        if (i == 0) {
+            m_energies.push_back(
+                    make_unique<Energy>(*m_configs.back(), replica_params));
+        }
+        else {
+            m_energies.push_back(make_unique<Energy>(
+                    *m_configs.back(),
+                    replica_params,
+                    m_energies.front()->get_potential_table()));
+        }
+        m_logs.push_back(make_unique<std::ofstream>(
+                params.m_output_filebase + "-replica-" + std::to_string(i) +
+                ".log"));
+        m_replicas.push_back(make_unique<NVTMCSimulation>(
+                *m_configs.back(),
+                *m_energies.back(),
+                replica_params,
+                *m_random_nums.back(),
+                *m_logs.back()));
+        m_temp_replicas.push_back(i);
+    }
+    m_swap_attempts.assign(m_temps.size() - 1, 0);
+    m_swap_accepts.assign(m_temps.size() - 1, 0);
+}
+
+void PTMCSimulation::run() {
+    auto start = steady_clock::now();
+    int num_replicas {static_cast<int>(m_replicas.size())};
+    stepT step {0};
+    while (step != m_steps) {
+        stepT num_steps {std::min(m_exchange_freq, m_steps - step)};
+        std::exception_ptr error {};
+#pragma omp parallel for num_threads(m_num_threads) schedule(dynamic, 1)
+        for (int i = 0; i < num_replicas; i++) {
+            try {
+                m_replicas[i]->run_steps(step + 1, num_steps);
+            }
+            catch (...) {
+#pragma omp critical
+                error = std::current_exception();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        step += num_steps;
+        attempt_exchanges();
+
+        // Check energies
+        if (multiple_passed(step, num_steps, m_energy_check_freq)) {
+            for (auto& replica: m_replicas) {
+                replica->check_energy(step);
+            }
+        }
+
+        // Log
+        if (multiple_passed(step, num_steps, m_logging_freq)) {
+            log_exchange(step);
+        }
+
+        // Check if maximum allowed time reached
+        std::chrono::duration<double> dt {(steady_clock::now() - start)};
+        if (dt.count() > m_duration) {
+            cout << "Maximum time allowed reached\n";
+            break;
+        }
+    }
+    log_summary();
+}
+
+void PTMCSimulation::attempt_exchanges() {
+    for (size_t i = m_exchanges % 2; i + 1 < m_temps.size(); i += 2) {
+        int replica1 {m_temp_replicas[i]};
+        int replica2 {m_temp_replicas[i + 1]};
+        eneT dbeta {1 / m_temps[i] - 1 / m_temps[i + 1]};
+        eneT dene {
+                m_replicas[replica1]->get_energy() -
+                m_replicas[replica2]->get_energy()};
+        double paccept {fmin(1, exp(dbeta * dene))};
+        m_swap_attempts[i]++;
+        if (m_random_num.uniform_real() < paccept) {
+            m_swap_accepts[i]++;
+            m_replicas[replica1]->set_temp(m_temps[i + 1]);
+            m_replicas[replica2]->set_temp(m_temps[i]);
+            m_temp_replicas[i] = replica2;
+            m_temp_replicas[i + 1] = replica1;
+        }
+    }
+    m_exchanges++;
+}
+
+void PTMCSimulation::log_exchange(stepT step) {
     cout << "Step: " << step << "\n";
-    cout << "Movetype: " << label << "\n";
-    cout << "Accepted: " << accepted << "\n";
-    cout << "Energy: " << m_energy.calc_total_energy() << "\n";
+    cout << "Temperature" << setw(10);
+    cout << "Replica" << setw(10);
+    cout << "Energy"
+         << "\n";
+    for (size_t i {0}; i != m_temps.size(); i++) {
+        int replica_i {m_temp_replicas[i]};
+        cout << m_temps[i] << setw(10);
+        cout << replica_i << setw(10);
+        cout << m_replicas[replica_i]->get_energy() << "\n";
+    }
     cout << "\n";
 }
 
-void NVTMCSimulation::log_summary() {
-    cout << "Run summary"
+void PTMCSimulation::log_summary() {
+    for (auto& replica: m_replicas) {
+        replica->log_summary();
+    }
+    cout << "Exchange summary"
          << "\n";
-    cout << "Movetype" << setw(10);
+    cout << "Temperatures" << setw(10);
     cout << "Attempts" << setw(10);
     cout << "Accepts" << setw(10);
     cout << "Frequency"
          << "\n";
-    for (size_t i {0}; i != m_movetypes.size(); i++) {
-        cout << m_movetypes[i]->get_label() << setw(10);
-        cout << m_move_attempts[i] << setw(10);
-        cout << m_move_accepts[i] << setw(10);
-        cout << static_cast<double>(m_move_accepts[i]) / m_move_attempts[i]
+    for (size_t i {0}; i != m_swap_attempts.size(); i++) {
+        cout << m_temps[i] << "-" << m_temps[i + 1] << setw(10);
+        cout << m_swap_attempts[i] << setw(10);
+        cout << m_swap_accepts[i] << setw(10);
+        cout << static_cast<double>(m_swap_accepts[i]) / m_swap_attempts[i]
              << "\n";
     }
 }
+
+EnsembleMCSimulation::EnsembleMCSimulation(
+        vector<string> param_filenames,
+        int reps,
+        int num_threads):
+        m_reps {reps}, m_num_threads {std::max(num_threads, 1)} {
+
+    if (m_reps < 1) {
+        cout << "Number of reps must be at least one\n";
+        throw InputError {};
+    }
+
+    // Potentials are created once for each parameter set
+    for (auto param_filename: param_filenames) {
+        InputParams params {param_filename};
+        if (params.m_sim_type != "nvt") {
+            cout << "Ensemble parameter sets must be of simulation type nvt\n";
+            throw InputError {};
+        }
+        RandomGens random_num {};
+        Config conf {params, random_num};
+        m_tables.push_back(make_shared<const PotentialTable>(conf, params));
+        m_params.push_back(params);
+    }
+}
+
+void EnsembleMCSimulation::run() {
+    int num_params {static_cast<int>(m_params.size())};
+    int num_runs {num_params * m_reps};
+    std::exception_ptr error {};
+#pragma omp parallel for num_threads(m_num_threads) schedule(dynamic, 1)
+    for (int i = 0; i < num_runs; i++) {
+        try {
+            run_rep(i % num_params, i / num_params);
+        }
+        catch (...) {
+#pragma omp critical
+            error = std::current_exception();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void EnsembleMCSimulation::run_rep(int params_i, int rep) {
+    InputParams params {m_params[params_i]};
+    params.m_output_filebase += "_rep-" + std::to_string(rep) + "-" +
+                                std::to_string(params_i);
+    std::ofstream log {params.m_output_filebase + ".log"};
+    RandomGens random_num {};
+    Config conf {params, random_num};
+    Energy ene {conf, params, m_tables[params_i]};
+    NVTMCSimulation sim {conf, ene, params, random_num, log};
+    sim.run();
+}
 } // namespace simulation
@@ -1,5 +1,8 @@
 // space.cpp
 
+#include <algorithm>
+#include <cmath>
+
 #include "BlobCrystallinOligomer/space.h"
 #include "BlobCrystallinOligomer/shared_types.h"
 
@@ -7,6 +10,8 @@ namespace space {
 
 using shared_types::distT;
 using shared_types::vecT;
+using std::find;
+using std::floor;
 
 CuboidPBC::CuboidPBC() {}
 
@@ -68,4 +73,173 @@ vecT CuboidPBC::unwrap(vecT pos1, vecT pos2) {
 
     return unwrapped;
 }
+
+CellList::CellList() {}
+
+void CellList::setup(distT box_len, distT min_cell_len, int num_items) {
+    m_box_len = box_len;
+    m_cells_per_side = 1;
+    if (min_cell_len > 0 and min_cell_len != shared_types::inf) {
+        m_cells_per_side = static_cast<int>(floor(box_len / min_cell_len));
+    }
+    if (m_cells_per_side < 3) {
+        m_cells_per_side = 1;
+    }
+    m_cell_len = box_len / m_cells_per_side;
+
+    int n {m_cells_per_side};
+    m_cell_items.assign(n * n * n, {});
+    m_adjacent_cells.assign(n * n * n, {});
+    for (int x {0}; x != n; x++) {
+        for (int y {0}; y != n; y++) {
+            for (int z {0}; z != n; z++) {
+                vector<int>& adjacent {m_adjacent_cells[(x * n + y) * n + z]};
+                for (int dx {-1}; dx != 2; dx++) {
+                    for (int dy {-1}; dy != 2; dy++) {
+                        for (int dz {-1}; dz != 2; dz++) {
+                            int ax {(x + dx + n) % n};
+                            int ay {(y + dy + n) % n};
+                            int az {(z + dz + n) % n};
+                            int cell {(ax * n + ay) * n + az};
+                            auto end {adjacent.end()};
+                            if (find(adjacent.begin(), end, cell) == end) {
+                                adjacent.push_back(cell);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    m_item_cell.assign(num_items, -1);
+    m_item_slot.assign(num_items, -1);
+}
+
+void CellList::update(int item_i, vecT pos) {
+    int cell {calc_cell(pos)};
+    int old_cell {m_item_cell[item_i]};
+    if (cell == old_cell) {
+        return;
+    }
+
+    // Swap item with last in old cell and remove
+    if (old_cell != -1) {
+        vector<int>& old_items {m_cell_items[old_cell]};
+        int slot {m_item_slot[item_i]};
+        int last_item {old_items.back()};
+        old_items[slot] = last_item;
+        m_item_slot[last_item] = slot;
+        old_items.pop_back();
+    }
+    m_item_slot[item_i] = m_cell_items[cell].size();
+    m_cell_items[cell].push_back(item_i);
+    m_item_cell[item_i] = cell;
+}
+
+vector<int> CellList::get_neighbours(vecT pos) {
+    vector<int> neighbours {};
+    for (int cell: m_adjacent_cells[calc_cell(pos)]) {
+        vector<int>& items {m_cell_items[cell]};
+        neighbours.insert(neighbours.end(), items.begin(), items.end());
+    }
+
+    return neighbours;
+}
+
+int CellList::get_cells_per_side() { return m_cells_per_side; }
+
+array<int, 3> CellList::calc_cell_coors(vecT& pos) {
+    int n {m_cells_per_side};
+    array<int, 3> coors;
+    for (int i {0}; i != 3; i++) {
+        int comp_cell {
+                static_cast<int>(floor((pos[i] + m_box_len / 2) / m_cell_len))};
+        coors[i] = ((comp_cell % n) + n) % n;
+    }
+
+    return coors;
+}
+
+int CellList::calc_cell(vecT& pos) {
+    int n {m_cells_per_side};
+    array<int, 3> coors {calc_cell_coors(pos)};
+
+    return (coors[0] * n + coors[1]) * n + coors[2];
+}
+
+VerletList::VerletList(CuboidPBC& pbc_space): m_space {pbc_space} {}
+
+void VerletList::setup(
+        distT box_len,
+        distT interaction_len,
+        distT skin,
+        int num_items) {
+
+    m_skin = skin;
+    m_list_len = interaction_len + skin;
+    CellList::setup(box_len, m_list_len, num_items);
+    m_pos.assign(num_items, {0, 0, 0});
+    m_ref_pos.assign(num_items, {0, 0, 0});
+    m_lists.assign(num_items, {});
+    m_stale = true;
+}
+
+void VerletList::update(int item_i, vecT pos) {
+    CellList::update(item_i, pos);
+    m_pos[item_i] = pos;
+    if (m_skin != 0 and not m_stale and not m_suspended and
+        m_space.calc_dist(pos, m_ref_pos[item_i]) > m_skin / 2) {
+        m_stale = true;
+    }
+}
+
+vector<int> VerletList::get_item_neighbours(int item_i, vecT pos) {
+    if (m_skin == 0 or m_suspended) {
+        return get_neighbours(pos);
+    }
+    update_lists();
+    if (m_space.calc_dist(pos, m_ref_pos[item_i]) > m_skin / 2) {
+        return get_neighbours(pos);
+    }
+
+    return m_lists[item_i];
+}
+
+void VerletList::update_lists() {
+    if (m_skin != 0 and m_stale) {
+        build_lists();
+    }
+}
+
+void VerletList::suspend_lists() { m_suspended = true; }
+
+void VerletList::resume_lists() {
+    m_suspended = false;
+    if (m_skin == 0 or m_stale) {
+        return;
+    }
+    for (size_t i {0}; i != m_pos.size(); i++) {
+        if (m_space.calc_dist(m_pos[i], m_ref_pos[i]) > m_skin / 2) {
+            m_stale = true;
+            break;
+        }
+    }
+}
+
+void VerletList::build_lists() {
+    for (size_t i {0}; i != m_pos.size(); i++) {
+        vector<int>& list {m_lists[i]};
+        list.clear();
+        for (int j: get_neighbours(m_pos[i])) {
+            if (static_cast<size_t>(j) == i) {
+                continue;
+            }
+            if (m_space.calc_dist(m_pos[i], m_pos[j]) <= m_list_len) {
+                list.push_back(j);
+            }
+        }
+    }
+    m_ref_pos = m_pos;
+    m_stale = false;
+}
 } // namespace space
@@ -74,3 +74,135 @@ SCENARIO("Basic tests of configuration property calculation and access") {
         }
     }
 }
+
+SCENARIO("Neighbouring monomers are found through the cell list") {
+    using config::Config;
+    using config::monomerArrayT;
+    using ifile::MonomerData;
+    using ifile::ParticleData;
+    using monomer::Monomer;
+    using random_gens::RandomGens;
+    using shared_types::CoorSet;
+    using shared_types::distT;
+    using shared_types::vecT;
+    using std::vector;
+
+    // Same neighbours are expected from cells alone and with Verlet lists
+    distT verlet_skin {GENERATE(0.0, 1.0)};
+
+    GIVEN("System with monomers of two simple particles at set positions") {
+        RandomGens random_num {};
+        distT box_len {30};
+        distT radius {1};
+        distT max_cutoff {2};
+        vector<distT> xs {0, 2, 8, 14.5, -14};
+        vector<MonomerData> mds;
+        for (size_t i {0}; i != xs.size(); i++) {
+            vector<ParticleData> pds;
+            for (int j {0}; j != 2; j++) {
+                vecT pos {xs[i] + j - 0.5, 0, 0};
+                vecT ore {0, 0, 0};
+                ParticleData pd {
+                        j, "", "SimpleParticle", 0, pos, ore, ore, ore};
+                pds.push_back(pd);
+            }
+            MonomerData md {static_cast<int>(i), 0, pds};
+            mds.push_back(md);
+        }
+        Config conf {
+                mds, random_num, box_len, radius, max_cutoff, verlet_skin};
+        auto is_neighbour = [&conf](int mi1, CoorSet coorset, int mi2) {
+            Monomer& mono {conf.get_monomer(mi1)};
+            for (Monomer& m: conf.get_monomer_neighbours(mono, coorset)) {
+                if (m.get_index() == mi2) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        WHEN("Neighbours of the monomer at the center are found") {
+            THEN("The adjacent monomer is included but not distant ones") {
+                REQUIRE(is_neighbour(0, CoorSet::current, 1));
+                REQUIRE(not is_neighbour(0, CoorSet::current, 2));
+                REQUIRE(not is_neighbour(0, CoorSet::current, 3));
+                REQUIRE(not is_neighbour(0, CoorSet::current, 0));
+            }
+        }
+        WHEN("Monomers are on opposite sides of the box") {
+            THEN("They are neighbours through the periodic boundary") {
+                REQUIRE(is_neighbour(3, CoorSet::current, 4));
+                REQUIRE(not is_neighbour(3, CoorSet::current, 0));
+            }
+        }
+        WHEN("A monomer has a trial position in the center of the box") {
+            Monomer& m3 {conf.get_monomer(3)};
+            m3.translate({-15, 0, 0});
+            THEN("Neighbours of the trial center are found") {
+                REQUIRE(is_neighbour(3, CoorSet::trial, 0));
+                REQUIRE(not is_neighbour(3, CoorSet::trial, 4));
+                REQUIRE(is_neighbour(3, CoorSet::current, 4));
+            }
+        }
+        WHEN("A distant monomer is moved next to the center monomer") {
+            Monomer& m2 {conf.get_monomer(2)};
+            m2.translate({-9, 0, 0});
+            THEN("It is only a neighbour once the move is made current") {
+                REQUIRE(not is_neighbour(0, CoorSet::current, 2));
+                m2.trial_to_current();
+                REQUIRE(is_neighbour(0, CoorSet::current, 2));
+            }
+        }
+        WHEN("A monomer is moved while the neighbour lists are suspended") {
+            Monomer& m2 {conf.get_monomer(2)};
+            conf.suspend_neighbour_lists();
+            m2.translate({-9, 0, 0});
+            m2.trial_to_current();
+            THEN("It is a neighbour both before and after resuming") {
+                REQUIRE(is_neighbour(0, CoorSet::current, 2));
+                conf.resume_neighbour_lists();
+                REQUIRE(is_neighbour(0, CoorSet::current, 2));
+                REQUIRE(not is_neighbour(0, CoorSet::current, 3));
+            }
+        }
+    }
+}
+
+SCENARIO("Monomers are ordered spatially by their cells") {
+    using config::Config;
+    using ifile::MonomerData;
+    using ifile::ParticleData;
+    using random_gens::RandomGens;
+    using shared_types::distT;
+    using shared_types::vecT;
+    using std::vector;
+
+    GIVEN("Monomers along a line with three in one cell") {
+        RandomGens random_num {};
+        distT box_len {30};
+        distT radius {1};
+        distT max_cutoff {2};
+        vector<distT> xs {0, 10, 0.5, -10, 1};
+        vector<MonomerData> mds;
+        for (size_t i {0}; i != xs.size(); i++) {
+            vector<ParticleData> pds;
+            for (int j {0}; j != 2; j++) {
+                vecT pos {xs[i] + j - 0.5, 0, 0};
+                vecT ore {0, 0, 0};
+                ParticleData pd {
+                        j, "", "SimpleParticle", 0, pos, ore, ore, ore};
+                pds.push_back(pd);
+            }
+            MonomerData md {static_cast<int>(i), 0, pds};
+            mds.push_back(md);
+        }
+        Config conf {mds, random_num, box_len, radius, max_cutoff, 0};
+
+        WHEN("The spatial order is found") {
+            vector<int> order {conf.calc_spatial_order()};
+            THEN("Monomers are ordered by cell and then by index") {
+                REQUIRE(order == vector<int> {3, 0, 2, 4, 1});
+            }
+        }
+    }
+}
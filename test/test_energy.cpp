@@ -0,0 +1,158 @@
+// test_energy.cpp
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Json/json.hpp"
+#include "catch2/catch.hpp"
+
+#include "BlobCrystallinOligomer/config.h"
+#include "BlobCrystallinOligomer/energy.h"
+#include "BlobCrystallinOligomer/monomer.h"
+#include "BlobCrystallinOligomer/param.h"
+#include "BlobCrystallinOligomer/random_gens.h"
+#include "BlobCrystallinOligomer/shared_types.h"
+#include "test_params.h"
+
+SCENARIO("Energies are only calculated with cutoffs covering the potentials") {
+    using config::Config;
+    using energy::Energy;
+    using monomer::Monomer;
+    using param::InputParams;
+    using random_gens::RandomGens;
+    using shared_types::CoorSet;
+    using shared_types::eneT;
+    using shared_types::InputError;
+
+    GIVEN("The test system with potential cutoffs of 20") {
+        InputParams params {test_params("")};
+        RandomGens random_num {};
+        Config conf {params, random_num};
+
+        WHEN("The maximum cutoff covers the potentials") {
+            Energy ene {conf, params};
+            THEN("The total energy includes every pair") {
+                eneT all_pairs_ene {0};
+                int num_monomers {conf.get_num_monomers()};
+                for (int i {0}; i != num_monomers; i++) {
+                    for (int j {i + 1}; j != num_monomers; j++) {
+                        all_pairs_ene += ene.calc_monomer_pair_energy(
+                                conf.get_monomer(i),
+                                CoorSet::current,
+                                conf.get_monomer(j),
+                                CoorSet::current);
+                    }
+                }
+                REQUIRE(all_pairs_ene != 0);
+                REQUIRE(ene.calc_total_energy() == Approx(all_pairs_ene));
+            }
+        }
+        WHEN("The maximum cutoff is less than a potential cutoff") {
+            params.m_max_cutoff = 10;
+            THEN("The energy is rejected") {
+                REQUIRE_THROWS_AS(Energy(conf, params), InputError);
+            }
+        }
+    }
+}
+
+SCENARIO("Clusters spanning the box are committed with consistent energies") {
+    using config::Config;
+    using config::monomerArrayT;
+    using energy::Energy;
+    using ifile::MonomerData;
+    using ifile::ParticleData;
+    using monomer::Monomer;
+    using param::InputParams;
+    using random_gens::RandomGens;
+    using shared_types::CoorSet;
+    using shared_types::distT;
+    using shared_types::eneT;
+    using shared_types::rotMatT;
+    using shared_types::vecT;
+    using std::vector;
+
+    GIVEN("Two monomers interacting across the box boundary") {
+        InputParams params {test_params("")};
+        RandomGens random_num {};
+        vector<distT> xs {22, -22};
+        vector<MonomerData> mds;
+        for (size_t i {0}; i != xs.size(); i++) {
+            vector<ParticleData> pds;
+            for (int j {0}; j != 2; j++) {
+                vecT pos {xs[i] + j - 0.5, 0, 0};
+                vecT ore {0, 0, 0};
+                ParticleData pd {
+                        j, "", "SimpleParticle", 3, pos, ore, ore, ore};
+                pds.push_back(pd);
+            }
+            MonomerData md {static_cast<int>(i), 1, pds};
+            mds.push_back(md);
+        }
+        Config conf {mds, random_num, 60, 1, params.m_max_cutoff, 0};
+        Energy ene {conf, params};
+        Monomer& monomer1 {conf.get_monomer(0)};
+        Monomer& monomer2 {conf.get_monomer(1)};
+        eneT ene1 {ene.calc_total_energy()};
+        REQUIRE(ene.get_pair_energy(monomer1, monomer2) != 0);
+
+        WHEN("They are rotated together about the origin and committed") {
+            vecT rot_c {0, 0, 0};
+            rotMatT rot_mat {Eigen::AngleAxisd(M_PI / 4, vecT::UnitZ())};
+            monomerArrayT cluster {monomer1, monomer2};
+            for (Monomer& monomer: cluster) {
+                monomer.rotate(rot_c, rot_mat);
+            }
+            eneT de {ene.trial_to_current(cluster)};
+            THEN("The cached pair energy and change in energy are updated") {
+                eneT pair_ene {ene.calc_monomer_pair_energy(
+                        monomer1, CoorSet::current,
+                        monomer2, CoorSet::current)};
+                REQUIRE(pair_ene == 0);
+                REQUIRE(ene.get_pair_energy(monomer1, monomer2) == pair_ene);
+                REQUIRE(ene.get_pair_energy(monomer2, monomer1) == pair_ene);
+                REQUIRE(de != 0);
+                REQUIRE(ene1 + de == Approx(ene.calc_total_energy()));
+            }
+        }
+    }
+}
+
+SCENARIO("The first interaction given for a pair of types is kept") {
+    using config::Config;
+    using energy::PotentialTable;
+    using nlohmann::json;
+    using param::InputParams;
+    using random_gens::RandomGens;
+
+    GIVEN("The test energy file with a later interaction for a pair") {
+        InputParams params {test_params("")};
+        RandomGens random_num {};
+        Config conf {params, random_num};
+        json energy_json;
+        std::ifstream energy_file {params.m_energy_filename};
+        energy_file >> energy_json;
+        json& interactions {energy_json["cgmonomer"]["energy"]["interactions"]};
+        interactions.push_back(
+                {{"pairs", {{3, 3}}}, {"potential", 6}, {"conformers", "any"}});
+        std::string filename {"test_duplicate_pot.json"};
+        std::ofstream duplicate_file {filename};
+        duplicate_file << energy_json;
+        duplicate_file.close();
+        params.m_energy_filename = filename;
+
+        WHEN("The potential table is created") {
+            PotentialTable table {conf, params};
+            THEN("The pair has the potential of the first interaction") {
+                REQUIRE(table.get_pair_potential(3, 1, 3, 1).kernel ==
+                        &table.get_kernel(3));
+                REQUIRE(table.get_pair_potential(3, 1, 3, -1).kernel ==
+                        &table.get_kernel(3));
+            }
+        }
+        std::remove(filename.c_str());
+    }
+}
@@ -0,0 +1,377 @@
+// test_movetype.cpp
+
+#include <algorithm>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "BlobCrystallinOligomer/config.h"
+#include "BlobCrystallinOligomer/energy.h"
+#include "BlobCrystallinOligomer/monomer.h"
+#include "BlobCrystallinOligomer/movetype.h"
+#include "BlobCrystallinOligomer/param.h"
+#include "BlobCrystallinOligomer/random_gens.h"
+#include "BlobCrystallinOligomer/shared_types.h"
+#include "test_params.h"
+
+namespace {
+
+/** Metropolis movetype with monomer selection exposed */
+class SelectionMetMCMovetype: public movetype::MetMCMovetype {
+  public:
+    using MetMCMovetype::MetMCMovetype;
+    using MetMCMovetype::select_monomer;
+};
+
+/** Checkerboard movetype with domains exposed */
+class DomainCheckerboardMetMCMovetype:
+        public movetype::CheckerboardMetMCMovetype {
+  public:
+    using CheckerboardMetMCMovetype::CheckerboardMetMCMovetype;
+    using CheckerboardMetMCMovetype::calc_domain;
+    using CheckerboardMetMCMovetype::m_colour_domains;
+    using CheckerboardMetMCMovetype::m_domain_monomers;
+};
+
+/** Speculative movetype with conflict checks exposed */
+class ConflictSpeculativeMetMCMovetype:
+        public movetype::SpeculativeMetMCMovetype {
+  public:
+    using SpeculativeMetMCMovetype::SpeculativeMetMCMovetype;
+    using SpeculativeMetMCMovetype::conflicts;
+    using SpeculativeMetMCMovetype::m_committed;
+};
+
+/** Virtual movetype with cluster building exposed */
+class ClusterVMMCMovetype: public movetype::VMMCMovetype {
+  public:
+    using VMMCMovetype::VMMCMovetype;
+    using VMMCMovetype::accept_move;
+    using VMMCMovetype::add_to_cluster;
+    using VMMCMovetype::frustrate_link;
+    using VMMCMovetype::in_cluster;
+    using VMMCMovetype::m_move_stamp;
+    using VMMCMovetype::reset_internal;
+};
+
+/** Check cached pair energies of all pairs against recalculation */
+bool pair_energies_consistent(config::Config& conf, energy::Energy& ene) {
+    using shared_types::CoorSet;
+    int num_monomers {conf.get_num_monomers()};
+    for (int i {0}; i != num_monomers; i++) {
+        monomer::Monomer& monomer1 {conf.get_monomer(i)};
+        for (int j {0}; j != num_monomers; j++) {
+            if (i == j) {
+                continue;
+            }
+            monomer::Monomer& monomer2 {conf.get_monomer(j)};
+            shared_types::eneT pair_ene {ene.calc_monomer_pair_energy(
+                    monomer1, CoorSet::current, monomer2, CoorSet::current)};
+            if (ene.get_pair_energy(monomer1, monomer2) !=
+                    Approx(pair_ene)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+SCENARIO("Sweeps select monomers in a fixed spatial order") {
+    using config::Config;
+    using energy::Energy;
+    using ifile::MonomerData;
+    using ifile::ParticleData;
+    using monomer::Monomer;
+    using param::InputParams;
+    using random_gens::RandomGens;
+    using shared_types::distT;
+    using shared_types::vecT;
+    using std::vector;
+
+    GIVEN("A translation movetype set to sweep distant monomers on a line") {
+        InputParams params {test_params("")};
+        RandomGens random_num {};
+        vector<distT> xs {0, 100, -50, 50, -100};
+        vector<MonomerData> mds;
+        for (size_t i {0}; i != xs.size(); i++) {
+            vector<ParticleData> pds;
+            for (int j {0}; j != 2; j++) {
+                vecT pos {xs[i] + j - 0.5, 0, 0};
+                vecT ore {0, 0, 0};
+                ParticleData pd {
+                        j, "", "SimpleParticle", 3, pos, ore, ore, ore};
+                pds.push_back(pd);
+            }
+            MonomerData md {static_cast<int>(i), 1, pds};
+            mds.push_back(md);
+        }
+        Config conf {mds, random_num, 300, 1, params.m_max_cutoff, 0};
+        Energy ene {conf, params};
+        SelectionMetMCMovetype movetype {
+                conf, ene, random_num, params, "Translation", "translation"};
+        movetype.set_sweep(true);
+        vector<int> order {conf.calc_spatial_order()};
+        int num_monomers {conf.get_num_monomers()};
+
+        WHEN("A sweep is made") {
+            vector<int> sweep {};
+            for (int i {0}; i != num_monomers; i++) {
+                sweep.push_back(movetype.select_monomer().get_index());
+            }
+            THEN("Each monomer is selected once in spatial order") {
+                REQUIRE(sweep == vector<int> {4, 2, 0, 3, 1});
+                REQUIRE(sweep == order);
+            }
+        }
+        WHEN("The configuration changes between sweeps") {
+            for (int i {0}; i != num_monomers; i++) {
+                movetype.select_monomer();
+            }
+            for (int i {0}; i != num_monomers; i++) {
+                Monomer& monomer {conf.get_monomer(i)};
+                monomer.translate({-2 * xs[i], 0, 0});
+                monomer.trial_to_current();
+            }
+            vector<int> sweep {};
+            for (int i {0}; i != num_monomers; i++) {
+                sweep.push_back(movetype.select_monomer().get_index());
+            }
+            THEN("The next sweep keeps the original order") {
+                REQUIRE(sweep == order);
+                REQUIRE(conf.calc_spatial_order() ==
+                        vector<int> {1, 3, 0, 2, 4});
+            }
+        }
+    }
+}
+
+SCENARIO("Speculative moves keep the energy consistent") {
+    using config::Config;
+    using energy::Energy;
+    using movetype::SpeculativeMetMCMovetype;
+    using param::InputParams;
+    using random_gens::RandomGens;
+    using shared_types::eneT;
+
+    GIVEN("The test system, with all monomers in range of each other") {
+        InputParams params {test_params(
+                "num_threads=4\n"
+                "speculative_batch=8\n")};
+        params.m_max_disp_tc = 0.1;
+        RandomGens random_num {};
+        Config conf {params, random_num};
+        Energy ene {conf, params};
+        SpeculativeMetMCMovetype movetype {
+                conf, ene, random_num, params, "Translation", "translation"};
+
+        WHEN("Batches of conflicting proposals are made") {
+            eneT ene1 {ene.calc_total_energy()};
+            eneT de {0};
+            int accepted {0};
+            for (int i {0}; i != 20; i++) {
+                accepted += movetype.move();
+                de += movetype.get_de();
+            }
+            THEN("The change in energy and cached pair energies are kept") {
+                REQUIRE(accepted != 0);
+                REQUIRE(ene1 + de == Approx(ene.calc_total_energy()));
+                REQUIRE(pair_energies_consistent(conf, ene));
+            }
+        }
+    }
+
+    GIVEN("A lattice of monomers spaced beyond interaction range") {
+        using ifile::MonomerData;
+        using ifile::ParticleData;
+        using shared_types::distT;
+        using shared_types::vecT;
+        using std::vector;
+
+        InputParams params {test_params(
+                "num_threads=4\n"
+                "speculative_batch=64\n")};
+        params.m_max_disp_tc = 1;
+        RandomGens random_num {};
+        distT box_len {200};
+        int per_side {4};
+        distT spacing {box_len / per_side};
+        vector<MonomerData> mds;
+        for (int i {0}; i != per_side * per_side * per_side; i++) {
+            vecT center {
+                    (i / (per_side * per_side)) * spacing,
+                    (i / per_side % per_side) * spacing,
+                    (i % per_side) * spacing};
+            vector<ParticleData> pds;
+            for (int j {0}; j != 2; j++) {
+                vecT pos {center + vecT {j - 0.5, 0, 0}};
+                vecT ore {0, 0, 0};
+                ParticleData pd {
+                        j, "", "SimpleParticle", 3, pos, ore, ore, ore};
+                pds.push_back(pd);
+            }
+            MonomerData md {i, 1, pds};
+            mds.push_back(md);
+        }
+        Config conf {mds, random_num, box_len, 1, params.m_max_cutoff, 0};
+        REQUIRE(spacing - 2 * params.m_max_disp_tc >
+                conf.get_interaction_len());
+        Energy ene {conf, params};
+        ConflictSpeculativeMetMCMovetype movetype {
+                conf, ene, random_num, params, "Translation", "translation"};
+
+        WHEN("A batch of every monomer is proposed") {
+            eneT ene1 {ene.calc_total_energy()};
+            bool accepted {movetype.move()};
+            THEN("Every move is accepted without evaluating it again") {
+                REQUIRE(accepted);
+                vector<int> committed {movetype.m_committed};
+                REQUIRE(committed.size() == 64);
+                movetype.m_committed.clear();
+                for (int proposal_i: committed) {
+                    REQUIRE_FALSE(movetype.conflicts(proposal_i));
+                    movetype.m_committed.push_back(proposal_i);
+                }
+                REQUIRE(ene1 + movetype.get_de() ==
+                        Approx(ene.calc_total_energy()));
+                REQUIRE(pair_energies_consistent(conf, ene));
+            }
+        }
+    }
+}
+
+SCENARIO("Checkerboard sweeps keep monomers in their domains") {
+    using config::Config;
+    using energy::Energy;
+    using ifile::MonomerData;
+    using ifile::ParticleData;
+    using param::InputParams;
+    using random_gens::RandomGens;
+    using shared_types::CoorSet;
+    using shared_types::distT;
+    using shared_types::eneT;
+    using shared_types::vecT;
+    using std::vector;
+
+    GIVEN("A lattice of interacting monomers with many domains per colour") {
+        InputParams params {test_params("num_threads=4\n")};
+        params.m_max_disp_tc = 10;
+        RandomGens random_num {};
+        distT box_len {200};
+        int per_side {12};
+        distT spacing {box_len / per_side};
+        vector<MonomerData> mds;
+        for (int i {0}; i != per_side * per_side * per_side; i++) {
+            vecT center {
+                    (i / (per_side * per_side)) * spacing,
+                    (i / per_side % per_side) * spacing,
+                    (i % per_side) * spacing};
+            vector<ParticleData> pds;
+            for (int j {0}; j != 2; j++) {
+                vecT pos {center + vecT {j - 0.5, 0, 0}};
+                vecT ore {0, 0, 0};
+                ParticleData pd {
+                        j, "", "SimpleParticle", 3, pos, ore, ore, ore};
+                pds.push_back(pd);
+            }
+            MonomerData md {i, 1, pds};
+            mds.push_back(md);
+        }
+        Config conf {mds, random_num, box_len, 1, params.m_max_cutoff, 0};
+        Energy ene {conf, params};
+        DomainCheckerboardMetMCMovetype movetype {
+                conf, ene, random_num, params, "Translation", "translation"};
+        REQUIRE(movetype.m_colour_domains[0].size() > 1);
+
+        WHEN("A parallel sweep is made") {
+            eneT ene1 {ene.calc_total_energy()};
+            bool accepted {movetype.move()};
+            THEN("The energy is consistent and no monomer left its domain") {
+                REQUIRE(accepted);
+                REQUIRE(ene1 + movetype.get_de() ==
+                        Approx(ene.calc_total_energy()));
+                REQUIRE(pair_energies_consistent(conf, ene));
+                vector<vector<int>>& domains {movetype.m_domain_monomers};
+                for (size_t i {0}; i != domains.size(); i++) {
+                    for (int monomer_i: domains[i]) {
+                        vecT center {conf.get_monomer(monomer_i).get_center(
+                                CoorSet::current)};
+                        REQUIRE(movetype.calc_domain(center) ==
+                                static_cast<int>(i));
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Virtual moves keep the energy consistent") {
+    using config::Config;
+    using energy::Energy;
+    using param::InputParams;
+    using random_gens::RandomGens;
+    using shared_types::eneT;
+
+    GIVEN("The test system and a virtual translation movetype") {
+        InputParams params {test_params("num_threads=4\n")};
+        params.m_max_disp_tc = 0.1;
+        RandomGens random_num {};
+        Config conf {params, random_num};
+        Energy ene {conf, params};
+        ClusterVMMCMovetype movetype {
+                conf, ene, random_num, params, "VMMC", "translation"};
+
+        WHEN("Virtual moves are made") {
+            eneT ene1 {ene.calc_total_energy()};
+            eneT de {0};
+            int accepted {0};
+            for (int i {0}; i != 20; i++) {
+                accepted += movetype.move();
+                de += movetype.get_de();
+            }
+            THEN("The change in energy and cached pair energies are kept") {
+                REQUIRE(accepted != 0);
+                REQUIRE(ene1 + de == Approx(ene.calc_total_energy()));
+                REQUIRE(pair_energies_consistent(conf, ene));
+            }
+        }
+    }
+}
+
+SCENARIO("Frustrated links only reject moves of monomers left out") {
+    using config::Config;
+    using energy::Energy;
+    using monomer::Monomer;
+    using param::InputParams;
+    using random_gens::RandomGens;
+
+    GIVEN("A cluster with two frustrated links to a monomer") {
+        InputParams params {test_params("")};
+        RandomGens random_num {};
+        Config conf {params, random_num};
+        Energy ene {conf, params};
+        ClusterVMMCMovetype movetype {
+                conf, ene, random_num, params, "VMMC", "translation"};
+        Monomer& seed {conf.get_monomer(0)};
+        Monomer& monomer {conf.get_monomer(1)};
+        movetype.m_move_stamp++;
+        movetype.add_to_cluster(seed);
+        movetype.frustrate_link(monomer.get_index());
+        movetype.frustrate_link(monomer.get_index());
+
+        WHEN("The monomer stays outside the cluster") {
+            THEN("The move is rejected") {
+                REQUIRE(not movetype.in_cluster(monomer.get_index()));
+                REQUIRE(not movetype.accept_move());
+            }
+        }
+        WHEN("The monomer then joins the cluster") {
+            movetype.add_to_cluster(monomer);
+            THEN("The move is no longer rejected") {
+                REQUIRE(movetype.in_cluster(monomer.get_index()));
+                REQUIRE(movetype.accept_move());
+            }
+        }
+    }
+}
@@ -0,0 +1,201 @@
+// test_ofile.cpp
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "BlobCrystallinOligomer/config.h"
+#include "BlobCrystallinOligomer/ifile.h"
+#include "BlobCrystallinOligomer/monomer.h"
+#include "BlobCrystallinOligomer/ofile.h"
+#include "BlobCrystallinOligomer/random_gens.h"
+#include "BlobCrystallinOligomer/shared_types.h"
+
+SCENARIO("Binary trajectories are read back frame by frame") {
+    using config::Config;
+    using ifile::BinaryTrajectoryHeader;
+    using ifile::BinaryTrajectoryInputFile;
+    using ifile::MonomerData;
+    using ifile::ParticleData;
+    using ifile::TrajectoryFrame;
+    using monomer::Monomer;
+    using ofile::BinaryTrajectoryOutputFile;
+    using random_gens::RandomGens;
+    using shared_types::distT;
+    using shared_types::vecT;
+    using std::string;
+    using std::vector;
+
+    GIVEN("Three frames of a system of three monomers written and closed") {
+        RandomGens random_num {};
+        distT box_len {10};
+        distT radius {1};
+        vector<MonomerData> mds;
+        for (int i {0}; i != 3; i++) {
+            vector<ParticleData> pds;
+            for (int j {0}; j != 2; j++) {
+                vecT pos {i * 2.0 + j, 0, 0};
+                vecT norm {0, 0, 1};
+                vecT orient {1, 0, 0};
+                vecT orient2 {0, 1, 0};
+                string form {"DoubleOrientedPatchyParticle"};
+                ParticleData pd {j, "", form, j, pos, norm, orient, orient2};
+                pds.push_back(pd);
+            }
+            MonomerData md {i, i % 2, pds};
+            mds.push_back(md);
+        }
+        Config conf {mds, random_num, box_len, radius};
+        string filename {"test_ofile.btr"};
+        {
+            BinaryTrajectoryOutputFile traj_file {filename, conf};
+            for (int step {0}; step != 3; step++) {
+                Monomer& mono {conf.get_monomer(1)};
+                mono.translate({0, 1, 0});
+                mono.trial_to_current();
+                traj_file.write_step(conf, step * 10);
+            }
+        }
+
+        WHEN("The file is opened") {
+            BinaryTrajectoryInputFile traj_file {filename};
+            THEN("The header and topology are as written") {
+                REQUIRE(traj_file.get_num_frames() == 3);
+                REQUIRE(traj_file.get_num_monomers() == 3);
+                REQUIRE(traj_file.get_num_particles() == 6);
+                REQUIRE(traj_file.get_box_len() == box_len);
+                REQUIRE(traj_file.get_radius() == radius);
+                REQUIRE(traj_file.get_particle_types()[1] == 1);
+                REQUIRE(traj_file.get_particle_monomers()[5] == 2);
+                REQUIRE(traj_file.get_step(2) == 20);
+            }
+        }
+        WHEN("Frames are read out of order") {
+            BinaryTrajectoryInputFile traj_file {filename};
+            TrajectoryFrame frame;
+            traj_file.read_frame(2, frame);
+            traj_file.read_frame(1, frame);
+            THEN("The requested frame is read") {
+                REQUIRE(frame.step == 10);
+                REQUIRE(frame.conformers == vector<std::int32_t> {0, 1, 0});
+                REQUIRE(frame.positions[3 * 2 + 0] == 2);
+                REQUIRE(frame.positions[3 * 2 + 1] == 2);
+                REQUIRE(frame.positions[3 * 4 + 1] == 0);
+                REQUIRE(frame.orientations[9 * 3 + 2] == 1);
+                REQUIRE(frame.orientations[9 * 3 + 3] == 1);
+                REQUIRE(frame.orientations[9 * 3 + 7] == 1);
+            }
+        }
+        WHEN("The index was not written") {
+            BinaryTrajectoryHeader header;
+            std::fstream file {
+                    filename,
+                    std::ios::in | std::ios::out | std::ios::binary};
+            file.read(reinterpret_cast<char*>(&header), sizeof(header));
+            header.num_frames = 0;
+            header.index_offset = 0;
+            file.seekp(0);
+            file.write(reinterpret_cast<char*>(&header), sizeof(header));
+            file.close();
+            THEN("The frames are found from the file size") {
+                BinaryTrajectoryInputFile traj_file {filename};
+                TrajectoryFrame frame;
+                traj_file.read_frame(2, frame);
+                REQUIRE(traj_file.get_num_frames() == 3);
+                REQUIRE(frame.step == 20);
+                REQUIRE(frame.positions[3 * 2 + 1] == 3);
+            }
+        }
+        std::remove(filename.c_str());
+    }
+}
+
+SCENARIO("Trajectory writers write every frame in step order") {
+    using config::Config;
+    using ifile::BinaryTrajectoryInputFile;
+    using ifile::MonomerData;
+    using ifile::ParticleData;
+    using ifile::TrajectoryFrame;
+    using ofile::ConfigFrame;
+    using ofile::TrajectoryWriter;
+    using random_gens::RandomGens;
+    using shared_types::stepT;
+    using shared_types::vecT;
+    using std::string;
+    using std::vector;
+
+    GIVEN("A system of three monomers and frames marked by their step") {
+        RandomGens random_num {};
+        vector<MonomerData> mds;
+        for (int i {0}; i != 3; i++) {
+            vecT pos {i * 2.0, 0, 0};
+            vecT ore {0, 0, 0};
+            ParticleData pd {0, "", "SimpleParticle", 0, pos, ore, ore, ore};
+            MonomerData md {i, 0, {pd}};
+            mds.push_back(md);
+        }
+        Config conf {mds, random_num, 10, 1};
+        ConfigFrame frame;
+        frame.snapshot(conf, 0);
+        string filebase {"test_writer"};
+        int num_frames {100};
+
+        // The writer is destroyed as soon as the last frame is given to it
+        auto write_frames = [&](int buffer_frames) {
+            TrajectoryWriter writer {filebase, conf, buffer_frames, true};
+            for (int i {0}; i != num_frames; i++) {
+                frame.step = i * 10;
+                frame.positions[0] = {static_cast<double>(i), 0, 0};
+                writer.write_frame(frame);
+            }
+        };
+        auto frames_in_order = [&]() {
+            BinaryTrajectoryInputFile traj_file {filebase + ".btr"};
+            if (traj_file.get_num_frames() != num_frames) {
+                return false;
+            }
+            TrajectoryFrame read_frame;
+            for (int i {0}; i != num_frames; i++) {
+                traj_file.read_frame(i, read_frame);
+                if (read_frame.step != static_cast<stepT>(i * 10) or
+                    read_frame.positions[0] != i) {
+                    return false;
+                }
+            }
+
+            return true;
+        };
+
+        WHEN("Frames are queued on three buffers") {
+            write_frames(3);
+            THEN("They are written in step order") {
+                REQUIRE(frames_in_order());
+            }
+        }
+        WHEN("Frames are written directly without buffers") {
+            write_frames(0);
+            THEN("They are written in step order") {
+                REQUIRE(frames_in_order());
+            }
+        }
+        WHEN("There is a buffer for every frame") {
+            write_frames(num_frames);
+            THEN("Queued frames are written before the writer stops") {
+                REQUIRE(frames_in_order());
+            }
+        }
+        WHEN("There is only one buffer") {
+            write_frames(1);
+            THEN("Each frame waits for the last rather than overwriting it") {
+                REQUIRE(frames_in_order());
+            }
+        }
+        for (string ext: {".btr", "_pipe.vtf", "_pipe.patch"}) {
+            std::remove((filebase + ext).c_str());
+        }
+    }
+}
@@ -0,0 +1,46 @@
+// test_params.h
+
+#ifndef TEST_PARAMS_H
+#define TEST_PARAMS_H
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "BlobCrystallinOligomer/param.h"
+
+/** Write a parameter file for the test alphaB system
+ *
+ * The system is the example system with conformers in a smaller box.
+ * Additional options are given one per line as in the parameter file.
+ */
+inline void write_test_params(std::string filename, std::string options) {
+    std::string data_dir {TEST_DATA_DIR};
+    std::ofstream file {filename};
+    file << "config_filename=" << data_dir << "/alphaB_config.json\n";
+    file << "energy_filename=" << data_dir << "/alphaB_pot.json\n";
+    file << "temp=1\n";
+    file << "max_cutoff=20\n";
+    file << "max_disp_tc=5\n";
+    file << "max_disp_rc=1\n";
+    file << "max_disp_a=1\n";
+    file << "logging_freq=0\n";
+    file << "output_filebase=test_system\n";
+    file << options;
+}
+
+/** Parameters for the test alphaB system with additional options
+ *
+ * The parameter file is written to the working directory while it is
+ * parsed.
+ */
+inline param::InputParams test_params(std::string options) {
+    std::string filename {"test_system.inp"};
+    write_test_params(filename, options);
+    param::InputParams params {filename};
+    std::remove(filename.c_str());
+
+    return params;
+}
+
+#endif // TEST_PARAMS_H
@@ -114,4 +114,31 @@ SCENARIO("Individual particles are moved in a box with PBC") {
             }
         }
     }
+
+    GIVEN("Two particles sharing a particle store") {
+        using particle::ParticleStore;
+        ParticleStore store {};
+        vecT s_pos2 {1, 1, 1};
+        Particle part1 {index, type, s_pos, s_ore, *pbc_space, store};
+        PatchyParticle part2 {index + 1, type, s_pos2, s_ore, *pbc_space, store};
+
+        THEN("Their coordinates are adjacent in the store") {
+            REQUIRE(store.get_num_particles() == 2);
+            REQUIRE(part1.get_store_index() == 0);
+            REQUIRE(part2.get_store_index() == 1);
+            REQUIRE(store.get_pos(1, CoorSet::current) == s_pos2);
+        }
+
+        WHEN("One is translated and made current") {
+            vecT d_pos {1, 0, 0};
+            part2.translate(d_pos);
+            part2.trial_to_current();
+            THEN("Only its coordinates in the store are changed") {
+                vecT e_pos {2, 1, 1};
+                REQUIRE(store.get_pos(1, CoorSet::current) == e_pos);
+                REQUIRE(store.get_pos(0, CoorSet::current) == s_pos);
+                REQUIRE(store.get_pos(0, CoorSet::trial) == s_pos);
+            }
+        }
+    }
 }
@@ -1,9 +1,16 @@
 // test_potential.cpp
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
 #include "catch2/catch.hpp"
 
 #include "BlobCrystallinOligomer/particle.h"
 #include "BlobCrystallinOligomer/potential.h"
+#include "BlobCrystallinOligomer/potential_batch.h"
+#include "BlobCrystallinOligomer/potential_kernel.h"
 #include "BlobCrystallinOligomer/shared_types.h"
 
 SCENARIO("Compare potential values to hand calculated values") {
@@ -221,3 +228,278 @@ SCENARIO("Compare potential values to hand calculated values") {
         }
     }
 }
+
+SCENARIO("Potential kernels agree with reference potentials") {
+    using particle::Orientation;
+    using potential::calc_kernel_energy;
+    using potential::PotentialKernel;
+    using shared_types::distT;
+    using shared_types::eneT;
+    using shared_types::vecT;
+
+    std::mt19937 gen {1};
+    std::normal_distribution<distT> normal {};
+    auto random_unit = [&]() {
+        vecT v {normal(gen), normal(gen), normal(gen)};
+        return vecT {v / v.norm()};
+    };
+
+    auto compare = [&](potential::PairPotential& pot,
+                       PotentialKernel kernel) {
+        for (distT rdist: {0.5, 0.95, 1.0, 1.2, 2.0, 3.9, 4.0, 5.0}) {
+            for (int i {0}; i != 10; i++) {
+                vecT diff {rdist * random_unit()};
+                Orientation ore1 {random_unit(), random_unit(), random_unit()};
+                Orientation ore2 {random_unit(), random_unit(), random_unit()};
+                eneT r_ene {pot.calc_energy(rdist, diff, ore1, ore2)};
+                eneT k_ene {
+                        calc_kernel_energy(kernel, rdist, diff, ore1, ore2)};
+                REQUIRE(k_ene == Approx(r_ene).margin(1e-12));
+            }
+        }
+        REQUIRE(potential::get_kernel_rcut(kernel) == pot.get_rcut());
+    };
+
+    GIVEN("Each potential form and its kernel") {
+        eneT eps {1.5};
+        distT sigl {1};
+        distT rcut {4};
+        distT siga1 {0.9};
+        distT siga2 {1.1};
+        distT sigt {1.2};
+        THEN("Energies agree for random separations and orientations") {
+            potential::ZeroPotential zero {};
+            compare(zero, potential::ZeroKernel {});
+            potential::HardSpherePotential hs {sigl};
+            compare(hs, potential::HardSphereKernel {sigl});
+            potential::SquareWellPotential sw {eps, rcut};
+            compare(sw, potential::SquareWellKernel {eps, rcut});
+            potential::HarmonicWellPotential hw {eps, rcut};
+            compare(hw, potential::HarmonicWellKernel {eps, rcut});
+            potential::AngularHarmonicWellPotential ahw {eps, rcut, siga1};
+            compare(ahw, potential::AngularHarmonicWellKernel {eps, rcut, siga1});
+            potential::ShiftedLJPotential lj {eps, sigl, rcut};
+            compare(lj, potential::ShiftedLJKernel {eps, sigl, rcut});
+            potential::PatchyPotential p {eps, sigl, rcut, siga1, siga2};
+            compare(p, potential::PatchyKernel {eps, sigl, rcut, siga1, siga2});
+            potential::OrientedPatchyPotential op {
+                    eps, sigl, rcut, siga1, siga2, sigt};
+            compare(op,
+                    potential::OrientedPatchyKernel {
+                            eps, sigl, rcut, siga1, siga2, sigt});
+            potential::DoubleOrientedPatchyPotential dop {
+                    eps, sigl, rcut, siga1, siga2, sigt};
+            compare(dop,
+                    potential::DoubleOrientedPatchyKernel {
+                            eps, sigl, rcut, siga1, siga2, sigt});
+        }
+    }
+    GIVEN("Patches facing away with orientations along the separation") {
+        eneT eps {1.5};
+        distT sigl {1};
+        distT rcut {4};
+        distT siga {0.01};
+        distT sigt {1.2};
+        distT rdist {2};
+        vecT diff {rdist, 0, 0};
+        Orientation ore1 {{-1, 0, 0}, {1, 0, 0}, {1, 0, 0}};
+        Orientation ore2 {{1, 0, 0}, {1, 0, 0}, {1, 0, 0}};
+        THEN("The kernels give zero without evaluating the dihedrals") {
+            potential::OrientedPatchyPotential op {
+                    eps, sigl, rcut, siga, siga, sigt};
+            potential::DoubleOrientedPatchyPotential dop {
+                    eps, sigl, rcut, siga, siga, sigt};
+            REQUIRE(op.calc_energy(rdist, diff, ore1, ore2) == 0);
+            REQUIRE(dop.calc_energy(rdist, diff, ore1, ore2) == 0);
+            for (bool fast_math: {false, true}) {
+                potential::OrientedPatchyKernel op_kernel {
+                        eps, sigl, rcut, siga, siga, sigt};
+                potential::DoubleOrientedPatchyKernel dop_kernel {
+                        eps, sigl, rcut, siga, siga, sigt};
+                op_kernel.fast_math = fast_math;
+                dop_kernel.fast_math = fast_math;
+                REQUIRE(op_kernel(rdist, diff, ore1, ore2) == 0);
+                REQUIRE(dop_kernel(rdist, diff, ore1, ore2) == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("Batched kernels agree with single pair kernels") {
+    using particle::Orientation;
+    using potential::calc_batch_energy;
+    using potential::calc_kernel_energy;
+    using potential::PairBatch;
+    using potential::PotentialKernel;
+    using shared_types::distT;
+    using shared_types::eneT;
+    using shared_types::vecT;
+
+    std::mt19937 gen {2};
+    std::normal_distribution<distT> normal {};
+    std::uniform_real_distribution<distT> uniform {0.5, 4};
+    auto random_unit = [&]() {
+        vecT v {normal(gen), normal(gen), normal(gen)};
+        return vecT {v / v.norm()};
+    };
+
+    eneT eps {1.5};
+    distT sigl {1};
+    distT rcut {4};
+    distT siga1 {0.9};
+    distT siga2 {1.1};
+    distT sigt {1.2};
+    PotentialKernel kernel {potential::ShiftedLJKernel {eps, sigl, rcut}};
+    GIVEN("Each batchable kernel") {
+        int kernel_form {GENERATE(0, 1, 2, 3)};
+        if (kernel_form == 1) {
+            kernel = potential::PatchyKernel {eps, sigl, rcut, siga1, siga2};
+        }
+        else if (kernel_form == 2) {
+            kernel = potential::OrientedPatchyKernel {
+                    eps, sigl, rcut, siga1, siga2, sigt};
+        }
+        else if (kernel_form == 3) {
+            kernel = potential::DoubleOrientedPatchyKernel {
+                    eps, sigl, rcut, siga1, siga2, sigt};
+        }
+        REQUIRE(potential::kernel_batchable(kernel));
+        WHEN("A batch of pairs within the cutoff is evaluated") {
+            int num_pairs {GENERATE(1, 7, 64)};
+            PairBatch batch {};
+            eneT e_ene {0};
+            for (int i {0}; i != num_pairs; i++) {
+                distT rdist {uniform(gen)};
+                vecT diff {rdist * random_unit()};
+                Orientation ore1 {random_unit(), random_unit(), random_unit()};
+                Orientation ore2 {random_unit(), random_unit(), random_unit()};
+                e_ene += calc_kernel_energy(kernel, rdist, diff, ore1, ore2);
+                batch.add_pair(rdist, diff, ore1, ore2);
+            }
+            THEN("The sum agrees with the single pair kernel") {
+                eneT c_ene {calc_batch_energy(kernel, batch)};
+                REQUIRE(c_ene == Approx(e_ene).epsilon(1e-12));
+            }
+        }
+    }
+    GIVEN("A kernel without a batched version") {
+        PotentialKernel sw_kernel {potential::SquareWellKernel {eps, rcut}};
+        THEN("It is not batchable") {
+            REQUIRE(not potential::kernel_batchable(sw_kernel));
+        }
+    }
+}
+
+SCENARIO("Fast math kernels approximate the exact kernels") {
+    using std::vector;
+    using particle::Orientation;
+    using potential::calc_batch_energy;
+    using potential::calc_kernel_energy;
+    using potential::PairBatch;
+    using potential::PotentialKernel;
+    using shared_types::distT;
+    using shared_types::eneT;
+    using shared_types::vecT;
+
+    GIVEN("The fast acos and exp") {
+        THEN("The acos error is within its bound over [-1, 1]") {
+            distT max_error {0};
+            for (int i {0}; i != 20001; i++) {
+                distT x {-1 + i * 1e-4};
+                distT error {std::fabs(potential::fast_acos(x) - std::acos(x))};
+                max_error = std::max(max_error, error);
+            }
+            INFO("Maximum acos error " << max_error);
+            REQUIRE(max_error <= potential::fast_acos_max_error);
+        }
+        THEN("The exp relative error is within its bound over [-700, 0]") {
+            eneT max_error {0};
+            for (int i {0}; i != 70001; i++) {
+                eneT x {-i * 1e-2};
+                eneT error {std::fabs(potential::fast_exp(x) / std::exp(x) - 1)};
+                max_error = std::max(max_error, error);
+            }
+            INFO("Maximum exp relative error " << max_error);
+            REQUIRE(max_error <= potential::fast_exp_max_error);
+        }
+        THEN("The exp is exact enough up to overflow and passes on NaN") {
+            eneT x {709};
+            eneT error {std::fabs(potential::fast_exp(x) / std::exp(x) - 1)};
+            REQUIRE(error <= potential::fast_exp_max_error);
+            REQUIRE(potential::fast_exp(710) == std::exp(710));
+            REQUIRE(std::isinf(potential::fast_exp(1e300)));
+            REQUIRE(std::isnan(potential::fast_exp(std::nan(""))));
+        }
+    }
+
+    GIVEN("Exact and fast versions of each angular kernel") {
+        std::mt19937 gen {3};
+        std::normal_distribution<distT> normal {};
+        std::uniform_real_distribution<distT> uniform {0.5, 4};
+        auto random_unit = [&]() {
+            vecT v {normal(gen), normal(gen), normal(gen)};
+            return vecT {v / v.norm()};
+        };
+        eneT eps {1.5};
+        distT sigl {1};
+        distT rcut {4};
+        distT siga1 {0.5};
+        distT siga2 {0.5};
+        distT sigt {1};
+        potential::AngularHarmonicWellKernel ahw {eps, rcut, siga1};
+        potential::PatchyKernel p {eps, sigl, rcut, siga1, siga2};
+        potential::OrientedPatchyKernel op {
+                eps, sigl, rcut, siga1, siga2, sigt};
+        potential::DoubleOrientedPatchyKernel dop {
+                eps, sigl, rcut, siga1, siga2, sigt};
+        vector<PotentialKernel> exact_kernels {ahw, p, op, dop};
+        ahw.fast_math = true;
+        p.fast_math = true;
+        op.fast_math = true;
+        dop.fast_math = true;
+        vector<PotentialKernel> fast_kernels {ahw, p, op, dop};
+
+        // Each angle error scales a Gaussian factor by at most
+        // exp(pi * error / sig^2), so the bound is loose for these widths
+        eneT bound {1e-6};
+        THEN("The relative energy error is bounded for random pairs") {
+            for (size_t k {0}; k != exact_kernels.size(); k++) {
+                eneT max_error {0};
+                PairBatch exact_batch {};
+                PairBatch fast_batch {};
+                eneT exact_sum {0};
+                for (int i {0}; i != 2000; i++) {
+                    distT rdist {uniform(gen)};
+                    vecT diff {rdist * random_unit()};
+                    Orientation ore1 {
+                            random_unit(), random_unit(), random_unit()};
+                    Orientation ore2 {
+                            random_unit(), random_unit(), random_unit()};
+                    eneT exact {calc_kernel_energy(
+                            exact_kernels[k], rdist, diff, ore1, ore2)};
+                    eneT fast {calc_kernel_energy(
+                            fast_kernels[k], rdist, diff, ore1, ore2)};
+                    if (exact != 0) {
+                        max_error = std::max(
+                                max_error, std::fabs(fast / exact - 1));
+                    }
+                    if (k != 0) {
+                        exact_batch.add_pair(rdist, diff, ore1, ore2);
+                        fast_batch.add_pair(rdist, diff, ore1, ore2);
+                        exact_sum += exact;
+                    }
+                }
+                INFO("Kernel " << k << " maximum relative error " << max_error);
+                REQUIRE(max_error <= bound);
+                if (k != 0) {
+                    eneT batch_exact {
+                            calc_batch_energy(exact_kernels[k], exact_batch)};
+                    eneT batch_fast {
+                            calc_batch_energy(fast_kernels[k], fast_batch)};
+                    REQUIRE(batch_exact == Approx(exact_sum).epsilon(1e-12));
+                    REQUIRE(batch_fast == Approx(batch_exact).epsilon(bound));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,427 @@
+// test_simulation.cpp
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch2/catch.hpp"
+
+#include "BlobCrystallinOligomer/config.h"
+#include "BlobCrystallinOligomer/energy.h"
+#include "BlobCrystallinOligomer/monomer.h"
+#include "BlobCrystallinOligomer/movetype.h"
+#include "BlobCrystallinOligomer/param.h"
+#include "BlobCrystallinOligomer/random_gens.h"
+#include "BlobCrystallinOligomer/shared_types.h"
+#include "BlobCrystallinOligomer/simulation.h"
+#include "test_params.h"
+
+namespace {
+
+/** Canonical simulation with tuning and scheduling exposed */
+class TunedNVTMCSimulation: public simulation::NVTMCSimulation {
+  public:
+    using NVTMCSimulation::NVTMCSimulation;
+    using NVTMCSimulation::get_movetype_prob;
+    using NVTMCSimulation::m_cum_probs;
+    using NVTMCSimulation::m_movetypes;
+    using NVTMCSimulation::m_schedule_attempts;
+    using NVTMCSimulation::m_schedule_disp2s;
+    using NVTMCSimulation::m_schedule_times;
+    using NVTMCSimulation::schedule_movetypes;
+    using NVTMCSimulation::select_movetype;
+    using NVTMCSimulation::tune_movetype;
+};
+
+/** Maximum displacements written by a movetype or movemap */
+template<typename MoveT>
+std::vector<double> get_amplitudes(MoveT& move) {
+    std::ostringstream out;
+    move.write_amplitudes(out);
+    std::istringstream lines {out.str()};
+    std::vector<double> amplitudes;
+    std::string line;
+    while (std::getline(lines, line)) {
+        amplitudes.push_back(std::stod(line.substr(line.find(": ") + 2)));
+    }
+
+    return amplitudes;
+}
+} // namespace
+
+SCENARIO("Integrated autocorrelation times of simple series") {
+    using simulation::calc_autocorrelation_time;
+    using std::vector;
+
+    std::mt19937 gen {1};
+    std::normal_distribution<double> noise {0, 1};
+    int n {100000};
+
+    GIVEN("Uncorrelated noise") {
+        vector<double> series;
+        for (int i {0}; i != n; i++) {
+            series.push_back(noise(gen));
+        }
+        THEN("The autocorrelation time is one") {
+            REQUIRE(calc_autocorrelation_time(series) == Approx(1).margin(0.1));
+        }
+    }
+    GIVEN("An autoregressive series with coefficient one half") {
+        vector<double> series {0};
+        for (int i {1}; i != n; i++) {
+            series.push_back(0.5 * series.back() + noise(gen));
+        }
+        THEN("The autocorrelation time is (1 + 0.5) / (1 - 0.5)") {
+            REQUIRE(calc_autocorrelation_time(series) == Approx(3).margin(0.2));
+        }
+    }
+    GIVEN("A constant series") {
+        vector<double> series(10, 1.0);
+        THEN("The autocorrelation time is undefined") {
+            REQUIRE(std::isnan(calc_autocorrelation_time(series)));
+        }
+    }
+}
+
+SCENARIO("Running energies are summed with compensation") {
+    using simulation::RunningEnergy;
+
+    GIVEN("Many changes below the precision of a large total") {
+        RunningEnergy ene {1e16};
+        for (int i {0}; i != 10000; i++) {
+            ene.add(1);
+        }
+        WHEN("They have been added") {
+            THEN("The total is the exact sum") {
+                REQUIRE(ene.get_total() == 1e16 + 1e4);
+            }
+        }
+        WHEN("The large total is then subtracted") {
+            ene.add(-1e16);
+            THEN("The compensation holds the small changes") {
+                REQUIRE(ene.get_total() == 1e4);
+            }
+        }
+    }
+    GIVEN("A change added and subtracted around a smaller one") {
+        RunningEnergy ene {1};
+        ene.add(1e100);
+        ene.add(1);
+        ene.add(-1e100);
+        WHEN("The total is taken") {
+            THEN("The smaller changes are kept") {
+                REQUIRE(ene.get_total() == 2);
+            }
+        }
+        WHEN("The total is reset") {
+            ene.reset(5);
+            THEN("The compensation is cleared") {
+                REQUIRE(ene.get_total() == 5);
+            }
+        }
+    }
+}
+
+SCENARIO("Maximum displacements are tuned towards the target acceptance") {
+    using config::Config;
+    using energy::Energy;
+    using movetype::NTDFlipMovemap;
+    using param::InputParams;
+    using random_gens::RandomGens;
+    using shared_types::CoorSet;
+    using std::string;
+    using std::vector;
+
+    GIVEN("Translations, rotations and NTD flips of the test system") {
+        InputParams params {test_params(
+                "steps=200\n"
+                "tune_steps=100\n"
+                "tune_interval=10\n"
+                "tune_target_accept=0.25\n"
+                "translation_met=1/3\n"
+                "rotation_met=1/3\n"
+                "ntd_flip=1/3\n")};
+        params.m_max_disp_tc = 1;
+        RandomGens random_num {};
+        Config conf {params, random_num};
+        Energy ene {conf, params};
+        std::ostringstream log;
+        TunedNVTMCSimulation sim {conf, ene, params, random_num, log};
+        auto tune = [&sim](int movetype_i, int accepts) {
+            for (int i {0}; i != 10; i++) {
+                sim.tune_movetype(movetype_i, i < accepts);
+            }
+        };
+
+        WHEN("Every attempt of an interval is accepted") {
+            tune(0, 10);
+            THEN("The displacement is at most doubled") {
+                REQUIRE(get_amplitudes(*sim.m_movetypes[0]) ==
+                        vector<double> {2});
+            }
+        }
+        WHEN("Every attempt of an interval is rejected") {
+            tune(0, 0);
+            THEN("The displacement is at most halved") {
+                REQUIRE(get_amplitudes(*sim.m_movetypes[0]) ==
+                        vector<double> {0.5});
+            }
+        }
+        WHEN("Rotations are accepted at twice the target for three intervals") {
+            for (int i {0}; i != 3; i++) {
+                tune(1, 5);
+            }
+            THEN("The angle is capped at a full turn") {
+                vector<double> amplitudes {get_amplitudes(*sim.m_movetypes[1])};
+                REQUIRE(amplitudes[0] == Approx(8));
+                REQUIRE(amplitudes[1] == Approx(2 * M_PI));
+            }
+        }
+        WHEN("NTD flips are tuned") {
+            tune(2, 10);
+            THEN("They have no displacements and still flip the conformer") {
+                REQUIRE(get_amplitudes(*sim.m_movetypes[2]).empty());
+                NTDFlipMovemap movemap {conf, random_num};
+                movemap.scale_amplitudes(0.5);
+                monomer::Monomer& monomer {conf.get_monomer(0)};
+                movemap.generate_movemap(monomer);
+                movemap.apply_movemap(monomer);
+                REQUIRE(monomer.get_conformer(CoorSet::trial) !=
+                        monomer.get_conformer(CoorSet::current));
+            }
+        }
+        WHEN("The simulation is run past the tuning steps") {
+            sim.run_steps(1, 100);
+            vector<vector<double>> tuned;
+            for (auto& movetype: sim.m_movetypes) {
+                tuned.push_back(get_amplitudes(*movetype));
+            }
+            sim.run_steps(101, 100);
+            THEN("The displacements are logged once and then fixed") {
+                for (size_t i {0}; i != tuned.size(); i++) {
+                    REQUIRE(get_amplitudes(*sim.m_movetypes[i]) == tuned[i]);
+                }
+                string tuned_log {"Tuned maximum displacements"};
+                string::size_type pos {log.str().find(tuned_log)};
+                REQUIRE(pos != string::npos);
+                REQUIRE(log.str().find(tuned_log, pos + 1) == string::npos);
+            }
+        }
+    }
+}
+
+SCENARIO("Movetypes are scheduled by measured efficiency") {
+    using config::Config;
+    using energy::Energy;
+    using param::InputParams;
+    using random_gens::RandomGens;
+    using std::string;
+    using std::vector;
+
+    GIVEN("Three movetypes of the test system with measured costs") {
+        InputParams params {test_params(
+                "schedule_steps=100\n"
+                "translation_met=1/2\n"
+                "rotation_met=1/4\n"
+                "ntd_flip=1/4\n")};
+        RandomGens random_num {};
+        Config conf {params, random_num};
+        Energy ene {conf, params};
+        std::ostringstream log;
+        TunedNVTMCSimulation sim {conf, ene, params, random_num, log};
+        vector<double> probs {0.5, 0.25, 0.25};
+        sim.m_schedule_times = {2, 1, 1};
+        sim.m_schedule_disp2s = {8, 1, 0};
+        sim.m_schedule_attempts = {10, 10, 10};
+
+        WHEN("The movetypes are scheduled") {
+            sim.schedule_movetypes();
+            THEN("Probabilities are weighted by the relative efficiency") {
+                vector<double> effs {4, 1, 0};
+                double mean_eff {0};
+                for (int i {0}; i != 3; i++) {
+                    mean_eff += probs[i] * effs[i];
+                }
+                vector<double> weights;
+                double total_weight {0};
+                for (int i {0}; i != 3; i++) {
+                    weights.push_back(
+                            probs[i] * std::max(effs[i] / mean_eff, 0.1));
+                    total_weight += weights.back();
+                }
+                for (int i {0}; i != 3; i++) {
+                    REQUIRE(sim.get_movetype_prob(i) ==
+                            Approx(weights[i] / total_weight));
+                    REQUIRE(sim.get_movetype_prob(i) > 0);
+                }
+                REQUIRE(sim.m_cum_probs.back() == Approx(1));
+            }
+            THEN("Every column of the schedule is separated") {
+                std::istringstream table {log.str()};
+                string line;
+                while (std::getline(table, line) and
+                       line != "Scheduled movetypes") {}
+                std::getline(table, line);
+                std::istringstream header {line};
+                vector<string> columns;
+                string column;
+                while (header >> column) {
+                    columns.push_back(column);
+                }
+                REQUIRE(columns ==
+                        vector<string> {
+                                "Movetype", "Time", "Disp2/s", "Probability"});
+            }
+        }
+        WHEN("No movetype was measured to displace monomers") {
+            sim.m_schedule_disp2s = {0, 0, 0};
+            sim.schedule_movetypes();
+            THEN("The given probabilities are kept") {
+                for (int i {0}; i != 3; i++) {
+                    REQUIRE(sim.get_movetype_prob(i) == Approx(probs[i]));
+                }
+            }
+        }
+        WHEN("Movetypes are selected with an empty range between others") {
+            sim.m_cum_probs = {0.25, 0.25, 1};
+            vector<int> counts(4, 0); // Last for beyond the ranges
+            int draws {10000};
+            for (int i {0}; i != draws; i++) {
+                counts[sim.select_movetype()]++;
+            }
+            THEN("Each is selected in proportion to its range") {
+                REQUIRE(counts[1] == 0);
+                REQUIRE(counts[3] == 0);
+                REQUIRE(counts[0] / static_cast<double>(draws) ==
+                        Approx(0.25).margin(0.02));
+                REQUIRE(counts[2] / static_cast<double>(draws) ==
+                        Approx(0.75).margin(0.02));
+            }
+        }
+    }
+}
+
+SCENARIO("Replicas are run on a team of threads") {
+    using param::InputParams;
+    using simulation::PTMCSimulation;
+    using std::stod;
+    using std::string;
+
+    GIVEN("Parallel tempering of the test system with four threads") {
+        InputParams params {test_params(
+                "sim_type=ptmc\n"
+                "temps=0.8 1 1.3 1.7\n"
+                "exchange_freq=20\n"
+                "energy_check_freq=100\n"
+                "num_threads=4\n"
+                "steps=200\n"
+                "duration=1000\n"
+                "translation_met=1/4\n"
+                "rotation_met=1/4\n"
+                "translation_vmmc=1/4\n"
+                "rotation_vmmc=1/4\n")};
+        WHEN("The simulation is run and its replica logs closed") {
+            std::ostringstream log;
+            std::streambuf* cout_buf {std::cout.rdbuf(log.rdbuf())};
+            {
+                PTMCSimulation sim {params};
+                REQUIRE_NOTHROW(sim.run());
+            }
+            std::cout.rdbuf(cout_buf);
+            THEN("Each pair of temperatures is tried every other exchange") {
+                std::istringstream summary {log.str()};
+                string line;
+                while (std::getline(summary, line) and
+                       line != "Exchange summary") {}
+                std::getline(summary, line);
+                for (int i {0}; i != 3; i++) {
+                    string temps;
+                    long attempts;
+                    long accepts;
+                    summary >> temps >> attempts >> accepts;
+                    std::getline(summary, line);
+                    REQUIRE(attempts == 5);
+                    REQUIRE(accepts >= 0);
+                    REQUIRE(accepts <= attempts);
+                }
+            }
+            THEN("The energy of each replica is checked in its own log") {
+                for (int i {0}; i != 4; i++) {
+                    std::ifstream replica_log {
+                            "test_system-replica-" + std::to_string(i) +
+                            ".log"};
+                    string line;
+                    int checks {0};
+                    double ene {0};
+                    auto value = [&line](string label) {
+                        return stod(line.substr(label.size()));
+                    };
+                    while (std::getline(replica_log, line)) {
+                        if (line.rfind("Calculated energy: ", 0) == 0) {
+                            ene = value("Calculated energy: ");
+                        }
+                        if (line.rfind("Energy drift: ", 0) == 0) {
+                            double drift {value("Energy drift: ")};
+                            double tol {1e-9 * std::max(1.0, std::abs(ene))};
+                            REQUIRE(std::abs(drift) <= tol);
+                            checks++;
+                        }
+                    }
+                    REQUIRE(checks == 2);
+                }
+            }
+        }
+        for (int i {0}; i != 4; i++) {
+            string log_filename {
+                    "test_system-replica-" + std::to_string(i) + ".log"};
+            std::remove(log_filename.c_str());
+        }
+    }
+}
+
+SCENARIO("Ensemble runs are run on a team of threads") {
+    using shared_types::InputError;
+    using simulation::EnsembleMCSimulation;
+    using std::string;
+    using std::vector;
+
+    GIVEN("Two single threaded parameter sets of the test system") {
+        vector<string> filenames {"test_ensemble-0.inp", "test_ensemble-1.inp"};
+        string options {
+                "steps=100\n"
+                "translation_met=1/2\n"
+                "rotation_vmmc=1/2\n"};
+        for (string filename: filenames) {
+            write_test_params(filename, options);
+        }
+        WHEN("Two reps of each are run with four threads") {
+            EnsembleMCSimulation sim {filenames, 2, 4};
+            THEN("The runs do not share the thread state of energies") {
+                REQUIRE_NOTHROW(sim.run());
+            }
+        }
+        WHEN("No reps are requested") {
+            THEN("The ensemble is rejected") {
+                REQUIRE_THROWS_AS(
+                        EnsembleMCSimulation(filenames, 0, 4), InputError);
+            }
+        }
+        for (string filename: filenames) {
+            std::remove(filename.c_str());
+        }
+        for (int params_i {0}; params_i != 2; params_i++) {
+            for (int rep {0}; rep != 2; rep++) {
+                string log_filename {
+                        "test_system_rep-" + std::to_string(rep) + "-" +
+                        std::to_string(params_i) + ".log"};
+                std::remove(log_filename.c_str());
+            }
+        }
+    }
+}